@@ -0,0 +1,116 @@
+/** @defgroup group17 account_pool
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef ACCOUNT_POOL_H
+#define ACCOUNT_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nonce_manager.h"
+
+/**
+ * @brief Pool of the unlocked accounts transactions are sent from.
+ *
+ * Every account has its own sequence of nonces, so a transaction that is stuck
+ * in the mempool only delays the later transactions of its own account. New
+ * transactions are assigned to the accounts with the fewest transactions in
+ * flight, and each account has at most max_in_flight transactions in flight.
+ * The pool is shared by all adapters sending from the same accounts to the
+ * same endpoint, so the writes of different tables and shards are spread over
+ * the accounts as well.
+ */
+class AccountPool {
+ public:
+  /**
+   * @brief Get the pool of a set of accounts of an endpoint, which is shared
+   * by all adapters sending from these accounts
+   *
+   * @param url Connection-url of the endpoint
+   * @param addresses Addresses of the accounts
+   * @param max_in_flight Maximum number of transactions in flight per account
+   * @return Pool of the accounts
+   */
+  static auto for_accounts(const std::string &url,
+                           const std::vector<std::string> &addresses,
+                           size_t max_in_flight)
+      -> std::shared_ptr<AccountPool>;
+
+  /**
+   * @brief Create a pool of accounts
+   *
+   * @param url Connection-url of the endpoint
+   * @param addresses Addresses of the accounts
+   * @param max_in_flight Maximum number of transactions in flight per account
+   */
+  AccountPool(const std::string &url, const std::vector<std::string> &addresses,
+              size_t max_in_flight);
+
+  AccountPool(const AccountPool &) = delete;
+  auto operator=(const AccountPool &) -> AccountPool & = delete;
+
+  /**
+   * @brief Reserve the senders of up to count transactions. Blocks until at
+   * least one account is below its limit of transactions in flight.
+   *
+   * @param count Number of transactions to send
+   * @return Address of the sender of each transaction, at least one and at
+   * most count; each one has to be released after its transaction is mined
+   * or failed
+   */
+  auto acquire(size_t count) -> std::vector<std::string>;
+
+  /**
+   * @brief Release the senders of transactions that are mined or failed
+   *
+   * @param addresses Addresses returned by acquire()
+   */
+  void release(const std::vector<std::string> &addresses);
+
+  /**
+   * @brief Hand out the next nonce of an account of the pool
+   *
+   * @param address Address of the account
+   * @param seed Called to read the transaction count of the account if its
+   * allocator is not seeded
+   * @param[out] nonce Allocated nonce
+   * @return true if successfull otherwise false (unknown account or seeding
+   * failed)
+   */
+  auto allocate_nonce(const std::string &address,
+                      const NonceManager::SEED_FUNCTION &seed, uint64_t &nonce)
+      -> bool;
+
+  /**
+   * @brief Seed the nonces of an account again with its next allocation, e.g.
+   * after one of its transactions was rejected
+   *
+   * @param address Address of the account
+   */
+  void invalidate(const std::string &address);
+
+  //! Number of accounts of the pool
+  auto size() const -> size_t { return accounts_.size(); }
+
+ private:
+  struct Account {
+    std::string address;
+    std::shared_ptr<NonceManager> nonces;
+    size_t in_flight = 0;
+  };
+
+  const size_t max_in_flight_;
+  std::vector<Account> accounts_;
+  std::map<std::string, size_t> index_;
+
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+#endif  // ACCOUNT_POOL_H
+/** @} */
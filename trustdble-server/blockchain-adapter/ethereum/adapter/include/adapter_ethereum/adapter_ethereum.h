@@ -5,25 +5,44 @@
 #ifndef ADAPTER_ETHEREUM_H
 #define ADAPTER_ETHEREUM_H
 
-#include <curl/curl.h>
-
+#include <atomic>
 #include <boost/log/trivial.hpp>
 #include <cstdint>
 #include <cstdio>
+#include <deque>
 #include <fstream>
 #include <iostream>
-#include <mutex>		
-#include <regex>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "adapter_interface/adapter_interface.h"
+#include "account_pool.h"
 #include "config_ethereum.h"
+#include "contract_pool.h"
+#include "curl_pool.h"
+#include "head_subscription.h"
+#include "put_batch_encoder.h"
+#include "rpc_decoder.h"
 #include "json.hpp"
 
-// interval in ms to check if block is mined
+// interval in ms to check if the pending transactions are mined
 #define MINING_CHECK_INTERVAL 200
+// maximum interval in ms to check the pending transactions while waiting for
+// new blocks, in case a notification is lost
+#define MINING_CHECK_MAX_INTERVAL 5000
+// maximum number of requests in one JSON-RPC batch (geth rejects larger ones)
+#define MAX_RPC_BATCH_SIZE 1000
+// size of the response in bytes a page of a table scan aims for
+#define SCAN_TARGET_PAGE_BYTES (1024 * 1024)
+// latency in ms of the pages of a table scan above which the page size stops
+// growing
+#define SCAN_MAX_PAGE_LATENCY 1000
+// maximum number of rows of a page of a table scan
+#define SCAN_MAX_PAGE_SIZE 10000
+// maximum number of blocks whose logs are requested with one eth_getLogs
+#define MAX_LOG_BLOCK_RANGE 10000
 // define waiting time in seconds in config file
 #define WAITING_TIME_IN_SEC 1000
 // keys and values of smart contrat are 32 byte and represented as hex
@@ -59,6 +78,8 @@ struct RpcParams {
   std::string transaction_ID;
   //! The client nonce for the request
   unsigned long nonce{0};
+  //! Whether the nonce is set, 0 is the nonce of the first transaction
+  bool has_nonce{false};
   /**
    * @brief Default constructor for RpcParams
    *
@@ -132,13 +153,30 @@ struct RpcParams {
   }
 };
 
+/**
+ * @brief Progress of an interrupted table scan, from which the next
+ * get_all_at() with the same token continues
+ *
+ */
+struct ScanCheckpoint : READ_TOKEN::PROGRESS {
+  //! Block the pages were read at
+  uint64_t block{0};
+  //! Number of keys of the table at the block
+  uint64_t size{0};
+  //! Index of the first key that was not requested yet
+  uint64_t next_key_id{0};
+  //! Key ranges (first key, number of keys) of pages that were not read
+  std::deque<std::pair<uint64_t, uint64_t>> missing;
+  //! Number of rows in the results of the scan when it was interrupted
+  size_t rows{0};
+};
+
 /**
  * @brief BC_Adapter implementation for Ethereum.
  *
  */
 class EthereumAdapter : public BcAdapter {
  public:
-  static std::mutex m;
   //! Constructor
   explicit EthereumAdapter();
   //! Destructor
@@ -152,10 +190,12 @@ class EthereumAdapter : public BcAdapter {
   auto shutdown() -> bool override;
   /**
    * @brief Put a batch of key-value pairs into the Ethereum blockchain using
-   * Rpc calls to the Ethereum endpoint; Transactions are sent to the Blockchain
-   * and then we check whether a transaction was successfully stored on the
-   * blockchain. Successful transactions are removed from the batch while failed
-   * transactions remain in the batch.
+   * Rpc calls to the Ethereum endpoint; The pairs are packed into as few
+   * putBatch transactions as the block gas limit allows (see
+   * plan_put_batches()). Transactions are sent to the Blockchain and then we
+   * check whether a transaction was successfully stored on the blockchain.
+   * Pairs of successful transactions are removed from the batch while pairs of
+   * failed transactions remain in the batch.
    *
    * @param batch Batch including multiple key-value pairs; Succesfully inserted
    * key-value pairs are removed from the batch
@@ -164,18 +204,46 @@ class EthereumAdapter : public BcAdapter {
    * key-value pairs)
    */
   auto put(std::map<const BYTES, const BYTES> &batch) -> int override;
-    
+  auto get(const BYTES &key, BYTES &result) -> int override;
+
   /**
-   * @brief Put a batch of key-value pairs into the Ethereum blockchain using
-   * Rpc calls to the Ethereum endpoint. 
+   * @brief Get the values of several keys with a single JSON-RPC batch request
+   * instead of one request per key
    *
-   * @param batch Batch including multiple key-value pairs
+   * @param keys Keys to look up
+   * @param[out] results Found key-value pairs are added to this map
    *
-   * @return Status code 0 on run without error
+   * @return Status code (0 if all keys were found, 1 otherwise)
+   */
+  auto get_batch(const std::vector<BYTES> &keys,
+                 std::map<const BYTES, BYTES> &results) -> int;
+  /**
+   * @brief Get all key-value pairs of the table. The number of keys is read
+   * with getSize() first, then the pages of getBatch() are fetched
+   * concurrently (scan-concurrency pages at a time). The page size starts at
+   * scan-page-size and adapts to the size and latency of the responses; a
+   * failed page (e.g. out of gas) is split and fetched again.
+   *
+   * All reads of a scan are pinned to the latest block.
+   *
+   * @param results Map to store the key-value pairs
+   * @return Status code (0 on success, 1 on failure)
    */
-  auto put_batch(std::map<const BYTES, const BYTES> &batch) -> int;
-  auto get(const BYTES &key, BYTES &result) -> int override;
   auto get_all(std::map<const BYTES, BYTES> &results) -> int override;
+
+  /**
+   * @brief Get all key-value pairs of the table like get_all(), with all
+   * reads pinned to the block of the token, or the latest block if the token
+   * has no position. If a page can't be read, the progress is kept in the
+   * token, and calling get_all_at() again with the same results and token only
+   * reads the missing pages at the same block.
+   *
+   * @param results Map to store the key-value pairs
+   * @param token Token of the preceding get_version()
+   * @return Status code (0 on success, 1 on failure)
+   */
+  auto get_all_at(std::map<const BYTES, BYTES> &results, READ_TOKEN &token)
+      -> int override;
   auto remove(const BYTES &key) -> int override;
 
   auto create_table(const std::string &name, std::string &tableAddress)
@@ -184,15 +252,64 @@ class EthereumAdapter : public BcAdapter {
       -> int override;
   auto drop_table() -> int override;
 
+  /**
+   * @brief The version of a table is the block of its last modification for
+   * version 2 contracts (lastModified()), otherwise the latest block number of
+   * the chain, since every modification of the contract is mined in a new
+   * block. The position of the token is the block the version was read at.
+   *
+   * @param token Token to store the version and block in
+   * @return Status code (0 on success, 1 on failure)
+   */
+  auto get_version(READ_TOKEN &token) -> int override;
+
+  /**
+   * @brief Read the changes of a version 2 table from the Put and Remove
+   * events of its contract (eth_getLogs), from the block after since up to
+   * the block of the token. The block range is split into requests of at most
+   * MAX_LOG_BLOCK_RANGE blocks.
+   *
+   * @param since Version (block of the last modification) of the rows
+   * @param token Token of the preceding get_version()
+   * @param puts Map to store the written keys with their latest values
+   * @param removes Vector to store the removed keys
+   * @return Status code (0 on success, 1 on failure, for tables of the first
+   * contract or a token without position)
+   */
+  auto get_changes(uint64_t since, const READ_TOKEN &token,
+                   std::map<const BYTES, BYTES> &puts,
+                   std::vector<BYTES> &removes) -> int override;
+
  private:
   std::string tableName_;
   std::string accountAddress_;
   std::string storedContractAddress_;
+  /**
+   * @brief Version of the contract of the table, 0 until it is read. It is
+   * read and written by all threads sharing the adapter; copies of the adapter
+   * (the deployer of the contract pool) start with the copied version.
+   */
+  struct ContractVersion {
+    std::atomic<uint64_t> value{0};
+
+    ContractVersion() = default;
+    ContractVersion(const ContractVersion &other) : value(other.value.load()) {}
+    auto operator=(const ContractVersion &other) -> ContractVersion & {
+      value = other.value.load();
+      return *this;
+    }
+  };
+  ContractVersion contract_version_;
   EthereumConfig config_;
 
-  CURL *curl_;
+  std::shared_ptr<CurlPool> curl_pool_;
   size_t max_waiting_time_;
-  std::atomic_uint64_t nonce_;
+  // sender accounts of the transactions, the first one is accountAddress_
+  std::shared_ptr<AccountPool> accounts_;
+  // pre-deployed contracts for new tables, null if contract-pool-size is 0
+  std::shared_ptr<ContractPool> contract_pool_;
+  // notifications of new blocks, null if ipc-path is not set
+  std::shared_ptr<HeadSubscription> heads_;
 
   /**
    * @brief Verify configuration path
@@ -209,11 +326,25 @@ class EthereumAdapter : public BcAdapter {
   static auto verify_network_config(const std::string &network_config) -> bool;
 
   /**
-   * @brief Update nonce for reading operations
+   * @brief Read the number of transactions sent from an account including
+   * pending ones, which is the nonce of its next transaction
+   *
+   * @param address Address of the account
+   * @param[out] count Transaction count
+   * @return true if successfull otherwise false
+   */
+  auto get_transaction_count(const std::string &address, uint64_t &count)
+      -> bool;
+
+  /**
+   * @brief Allocate the nonce of a new transaction of a sender account without
+   * a request to the blockchain (except for seeding the allocator)
    *
+   * @param address Address of the sender account
+   * @param[out] nonce Allocated nonce
    * @return true if successfull otherwise false
    */
-  auto update_nonce() -> bool;
+  auto allocate_nonce(const std::string &address, uint64_t &nonce) -> bool;
 
   /**
    * @brief Initialize adapter after config is set
@@ -225,7 +356,8 @@ class EthereumAdapter : public BcAdapter {
   /**
    * @brief Helper-Method to do a RPC call to the blockchain
    *
-   * @param params RpcParams struct containing parameters of the call
+   * @param params RpcParams struct containing parameters of the call, a
+   * transaction without sender is sent from an account of the pool
    *
    * @param set_gas True gas will be set otherwise not
    *
@@ -234,41 +366,148 @@ class EthereumAdapter : public BcAdapter {
   auto call(RpcParams params, bool set_gas) -> std::string;
 
   /**
-   * @brief Helper-Method to do a RPC call to the blockchain
+   * @brief Helper-Method to do a RPC call to the blockchain. Transactions are
+   * only sent, use send_transaction() to get their ID.
    *
    * @param params Json-formatted string containing parameters of the call
    *
    * @param method RPC-Method that is call on the blockchain e.g.:
-   * "eth_sendTransaction", "eth_call", ...
+   * "eth_call", "eth_getTransactionCount", ...
    *
    * @return Response of the blockchain
    */
   auto call(std::string &params, std::string &method) -> std::string;
 
   /**
-   * @brief Helper-Method to periodically poll the blockchain to check if a
-   * transaction was mined. The poll interval is defined by
-   * MINING_CHECK_INTERVAL constant. It aborts if max-waiting-time is reached.
+   * @brief Helper-Method to post a JSON-RPC request (or an array of requests)
+   * to the Ethereum endpoint over a connection of its pool
+   *
+   * @param post_data Json-formatted request
+   *
+   * @return Raw response of the endpoint
+   */
+  auto post(const std::string &post_data) -> std::string;
+
+  /**
+   * @brief Helper-Method to do several RPC calls to the blockchain with one
+   * JSON-RPC batch request (split into chunks of MAX_RPC_BATCH_SIZE). Each
+   * request gets a distinct id which is used to match the responses, since
+   * the endpoint may answer in any order.
+   *
+   * @param requests Pairs of RPC-Method and Json-formatted parameters
+   *
+   * @return Response object of every request in the order of requests, null
+   * if the endpoint did not answer the request
+   */
+  auto call_batch(
+      const std::vector<std::pair<std::string, std::string>> &requests)
+      -> std::vector<nlohmann::json>;
+
+  /**
+   * @brief Helper-Method to send a transaction without waiting until it is
+   * mined
+   *
+   * @param params Json-formatted string containing the parameters of the
+   * transaction (including its nonce)
+   * @param from Address of the sender of the transaction
+   *
+   * @return ID (hash) of the transaction, empty if it was rejected
+   */
+  auto send_transaction(const std::string &params, const std::string &from)
+      -> std::string;
+
+  /**
+   * @brief Helper-Method to wait until a set of transactions is mined. All
+   * pending receipts are requested with a single JSON-RPC batch request every
+   * MINING_CHECK_INTERVAL ms until all transactions are mined or
+   * max-waiting-time is reached. With a subscription to new blocks they are
+   * requested right away and then whenever a new block arrives.
+   *
+   * @param transaction_IDs IDs of the transactions to wait for
+   * @param[out] mined_receipts Receipts of the successful transactions by
+   * their ID (optional)
+   *
+   * @return IDs of the transactions that failed or were not mined in time
+   */
+  auto await_receipts(
+      const std::vector<std::string> &transaction_IDs,
+      std::map<std::string, nlohmann::json> *mined_receipts = nullptr)
+      -> std::set<std::string>;
+
+  /**
+   * @brief Deploy new instances of the compiled contract at contract-path.
+   * The deployments are sent from the accounts of the pool with one batch
+   * request and confirmed together.
+   *
+   * @param count Number of contracts to deploy
+   * @param[out] addresses Addresses of the deployed contracts are added
+   * @return Status code (0 on success, 1 if not all contracts were deployed)
+   */
+  auto deploy_contracts(size_t count, std::vector<std::string> &addresses)
+      -> int;
+
+  /**
+   * @brief Read the number of the latest block
+   *
+   * @param[out] block Block number
+   * @return true if successfull otherwise false
+   */
+  auto get_block_number(uint64_t &block) -> bool;
+
+  /**
+   * @brief Read the number of keys stored in the contract
+   *
+   * @param block Block to read at
+   * @param[out] size Number of keys
+   * @return Status code (0 on success, 1 on failure)
+   */
+  auto get_size(uint64_t block, uint64_t &size) -> int;
+
+  /**
+   * @brief Read the version of the contract of the table once. Contracts
+   * before version 2 store values as string and have no version() method, so
+   * their call reverts. Other errors of the node are not remembered.
    *
-   * @param transaction_ID The ID of the transaction that is being checked to
-   * see if it was mined
+   * @return Version of the contract, 1 if it can't be read
+   */
+  auto get_contract_version() -> uint64_t;
+
+  /**
+   * @brief Fetch a page of a table scan with getBatch(), decoded according to
+   * the version of the contract (get_contract_version())
+   *
+   * @param key_id Index of the first key of the page
+   * @param page_size Number of keys of the page
+   * @param block Block to read at
+   * @param[out] results Key-value pairs of the page
+   * @param[out] response_size Size of the response in bytes
+   * @return Status code (0 on success, 1 on failure)
+   */
+  auto get_page(uint64_t key_id, uint64_t page_size, uint64_t block,
+                std::map<const BYTES, BYTES> &results, size_t &response_size)
+      -> int;
+
+  /**
+   * @brief Read the gas limit of the latest block
    *
-   * @return Transaction response of the blockchain. If the transaction was
-   * mined it contains the block number and hash, otherwise block number and
-   * hash are null;
+   * @param[out] gas_limit Gas limit of the block
+   * @return true if successfull otherwise false
    */
-  auto check_mining_result(std::string &transaction_ID) -> std::string;
+  auto get_block_gas_limit(uint64_t &gas_limit) -> bool;
 
   /**
-   * @brief Helper-Method to check the transation state after mining the
-   * transaction
+   * @brief Split the rows of a put into putBatch transactions with
+   * PutBatchEncoder::plan(), estimating the gas of the candidate transactions
+   * with one batch request of eth_estimateGas
    *
-   * @param transcation_ID The ID of the transaction whose state is to be
-   * checked
+   * @param rows Hex-encoded keys and values of the put
+   * @param block_gas_limit Gas limit of the latest block
    *
-   * @return True if transaction was successful, otherwise false
-   *    */
-  auto check_transaction_receipt(std::string &transaction_ID) -> bool;
+   * @return Chunks covering all rows, with their gas limit
+   */
+  auto plan_put_batches(
+      const std::vector<std::pair<std::string, std::string>> &rows,
+      uint64_t block_gas_limit) -> std::vector<PutBatchChunk>;
 
   /**
    * @brief Helper-Method to parse a RpcParam struct to json
@@ -300,34 +539,13 @@ class EthereumAdapter : public BcAdapter {
    */
   static auto convert_to_32byte(const std::string &data) -> std::string;
 
-  /**
-   * @brief Helper-Method to split and parse concatenated hex-encoded response
-   * from blockchain contract when doing a table scan. It extracts a key list
-   * and value list that are returned as a tuple vector.
-   *
-   * @param response Blockchain contract response as concatenated hex-encoded
-   * string
-   *
-   * @param split_length Length of an element in the response.
-   * Default=VALUE_SIZE of ethereum (64)
-   *
-   * @return A vector of string tuples containing key and value
-   */
-  static auto split(const std::string &response, int split_length = VALUE_SIZE)
-      -> std::map<const BYTES, BYTES>;
-
-  /**
-   * @brief Callback function for curl
-   */
-  static auto write_callback(char *contents, size_t size, size_t nmemb,
-                             void *userp) -> size_t;
-
   /**
    * @brief Helper-Method to do a RPC call to the blockchain for batch
    * processing
    *
    * @param batch Map that consists of a RpcParams struct and a boolean for
-   * setting gas or not
+   * setting the default gas or not, a gas already set in the struct is kept.
+   * Transactions without sender are sent from the account of the adapter.
    *
    * @param key_map Map that consists of a RpcParams struct and its
    * corresponding input key that is associated with these parameters
@@ -341,15 +559,16 @@ class EthereumAdapter : public BcAdapter {
   
   /**
    * @brief Helper-Method to do a RPC call to the blockchain for batch
-   * processing
+   * processing. All transactions are sent with one JSON-RPC batch request,
+   * then they are confirmed together with await_receipts().
    *
    * @param batch Map that consists of a Json-formatted string containing
    * parameters of the call and the RPC-Method that is called on the Blockchain,
    * e.g., "eth_sendTransaction"
    *
    * @param key_map Map that consists of a Json-formatted string containing
-   * parameters of the call and the original key that is associated with these
-   * parameters
+   * parameters of the call and the original key (or chunk of keys) that is
+   * associated with these parameters
    *
    * @return Vector that contains the keys where processing failed
    */
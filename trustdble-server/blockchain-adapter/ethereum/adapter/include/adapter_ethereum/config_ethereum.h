@@ -9,6 +9,18 @@
 
 #include "adapter_interface/adapter_config.h"
 
+// number of pages of a table scan that are fetched concurrently by default
+#define DEFAULT_SCAN_CONCURRENCY 8
+// number of rows of the first page of a table scan by default
+#define DEFAULT_SCAN_PAGE_SIZE 100
+// number of unlocked accounts transactions are sent from by default
+#define DEFAULT_SENDER_ACCOUNTS 1
+// number of transactions in flight per sender account by default (geth
+// guarantees 16 executable transactions per account in its pool)
+#define DEFAULT_MAX_PENDING_TRANSACTIONS 16
+// number of pre-deployed contracts kept for new tables by default (disabled)
+#define DEFAULT_CONTRACT_POOL_SIZE 0
+
 /**
  * @brief Define specific configuration values for the Ethereum adapter
  *
@@ -96,6 +108,71 @@ class EthereumConfig : public AdapterConfig {
   auto script_path() -> std::string {
     return config_.get<std::string>("Adapter-Ethereum.script-path");
   }
+
+  /**
+   * @brief The maximum number of pages of a table scan that are fetched
+   * concurrently (optional)
+   *
+   * @return int
+   */
+  auto scan_concurrency() -> int {
+    return config_.get<int>("Adapter-Ethereum.scan-concurrency",
+                            DEFAULT_SCAN_CONCURRENCY);
+  }
+
+  /**
+   * @brief The number of rows of the first page of a table scan, the size of
+   * the following pages adapts to the size of the rows (optional)
+   *
+   * @return int
+   */
+  auto scan_page_size() -> int {
+    return config_.get<int>("Adapter-Ethereum.scan-page-size",
+                            DEFAULT_SCAN_PAGE_SIZE);
+  }
+
+  /**
+   * @brief The number of unlocked accounts of the node transactions are sent
+   * from, starting with the first one returned by eth_accounts (optional)
+   *
+   * @return int
+   */
+  auto sender_accounts() -> int {
+    return config_.get<int>("Adapter-Ethereum.sender-accounts",
+                            DEFAULT_SENDER_ACCOUNTS);
+  }
+
+  /**
+   * @brief The maximum number of transactions in flight per sender account
+   * (optional)
+   *
+   * @return int
+   */
+  auto max_pending_transactions() -> int {
+    return config_.get<int>("Adapter-Ethereum.max-pending-transactions",
+                            DEFAULT_MAX_PENDING_TRANSACTIONS);
+  }
+
+  /**
+   * @brief The number of empty contracts that are deployed in advance, so
+   * creating a table only claims one of them (optional, 0 disables the pool)
+   *
+   * @return int
+   */
+  auto contract_pool_size() -> int {
+    return config_.get<int>("Adapter-Ethereum.contract-pool-size",
+                            DEFAULT_CONTRACT_POOL_SIZE);
+  }
+
+  /**
+   * @brief Path of the IPC socket of the node (e.g. geth.ipc), used to be
+   * notified of new blocks instead of polling for receipts (optional)
+   *
+   * @return std::string
+   */
+  auto ipc_path() -> std::string {
+    return config_.get<std::string>("Adapter-Ethereum.ipc-path", "");
+  }
 };
 #endif  // CONFIG_ETHEREUM_H
 /** @} */
@@ -0,0 +1,81 @@
+/** @defgroup group18 contract_pool
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef CONTRACT_POOL_H
+#define CONTRACT_POOL_H
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Pool of pre-deployed, empty table contracts.
+ *
+ * Creating a table claims a contract of the pool instead of deploying a new
+ * one and waiting until it is mined. Claimed contracts are replaced in the
+ * background, all missing contracts are deployed together. Contracts that are
+ * not claimed when the process ends are left unused on the chain.
+ */
+class ContractPool {
+ public:
+  /**
+   * @brief Deploys the given number of contracts and adds their addresses to
+   * the vector, returns a status code (0 on success, 1 on failure)
+   */
+  using DEPLOY_FUNCTION =
+      std::function<int(size_t, std::vector<std::string> &)>;
+
+  /**
+   * @brief Get the pool of a contract, which is shared by all adapters
+   * deploying it to the same endpoint
+   *
+   * @param key Identifies endpoint and compiled contract of the pool
+   * @param size Number of contracts the pool keeps deployed
+   * @param deploy Called to create a pool that does not exist yet, returns
+   * the function deploying the contracts
+   * @return Pool of the contract
+   */
+  static auto for_contract(const std::string &key, size_t size,
+                           const std::function<DEPLOY_FUNCTION()> &deploy)
+      -> std::shared_ptr<ContractPool>;
+
+  /**
+   * @brief Create a pool and start to fill it in the background
+   *
+   * @param size Number of contracts the pool keeps deployed
+   * @param deploy Function deploying the contracts
+   */
+  ContractPool(size_t size, DEPLOY_FUNCTION deploy);
+
+  //! Waits for a running refill
+  ~ContractPool();
+
+  ContractPool(const ContractPool &) = delete;
+  auto operator=(const ContractPool &) -> ContractPool & = delete;
+
+  /**
+   * @brief Take a contract of the pool and start a refill in the background
+   *
+   * @param[out] address Address of the claimed contract
+   * @return true if a contract was available otherwise false
+   */
+  auto claim(std::string &address) -> bool;
+
+ private:
+  const size_t size_;
+  const DEPLOY_FUNCTION deploy_;
+
+  std::mutex mutex_;
+  std::deque<std::string> contracts_;
+  std::future<void> refill_;
+
+  //! Start a refill unless one is running, the mutex has to be held
+  void start_refill();
+};
+#endif  // CONTRACT_POOL_H
+/** @} */
@@ -0,0 +1,79 @@
+/** @defgroup group15 curl_pool
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef CURL_POOL_H
+#define CURL_POOL_H
+
+#include <curl/curl.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// number of idle connections kept open per endpoint
+#define MAX_IDLE_CONNECTIONS 32
+
+/**
+ * @brief Pool of curl handles (HTTP connections kept alive) to one Ethereum
+ * endpoint.
+ *
+ * Every request takes an idle handle or opens a new connection if all are in
+ * use, so requests of different adapters (tables, shards, sessions) are in
+ * flight at the same time. Reusing a handle reuses its open connection.
+ */
+class CurlPool {
+ public:
+  /**
+   * @brief Get the pool of an endpoint, which is shared by all adapters
+   * connected to it
+   *
+   * @param url Connection-url of the endpoint
+   * @return Pool of the endpoint
+   */
+  static auto for_endpoint(const std::string &url) -> std::shared_ptr<CurlPool>;
+
+  /**
+   * @brief Create an empty pool, connections are opened on demand
+   *
+   * @param url Connection-url of the endpoint
+   */
+  explicit CurlPool(std::string url);
+
+  //! Closes the idle connections
+  ~CurlPool();
+
+  CurlPool(const CurlPool &) = delete;
+  auto operator=(const CurlPool &) -> CurlPool & = delete;
+
+  /**
+   * @brief Post a JSON request to the endpoint
+   *
+   * @param post_data Json-formatted request
+   * @param[out] response Raw response of the endpoint
+   * @return Result code of curl
+   */
+  auto post(const std::string &post_data, std::string &response) -> CURLcode;
+
+ private:
+  std::string url_;
+  struct curl_slist *headers_;
+
+  std::mutex mutex_;
+  std::vector<CURL *> idle_;
+
+  //! Take an idle handle or create a new one
+  auto acquire() -> CURL *;
+
+  //! Return a handle after its request finished
+  void release(CURL *curl);
+
+  /**
+   * @brief Callback function for curl
+   */
+  static auto write_callback(char *contents, size_t size, size_t nmemb,
+                             void *userp) -> size_t;
+};
+#endif  // CURL_POOL_H
+/** @} */
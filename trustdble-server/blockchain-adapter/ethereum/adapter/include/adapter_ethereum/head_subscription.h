@@ -0,0 +1,91 @@
+/** @defgroup group19 head_subscription
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef HEAD_SUBSCRIPTION_H
+#define HEAD_SUBSCRIPTION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// interval in ms to reconnect to the IPC socket after the connection failed
+#define IPC_RECONNECT_INTERVAL 1000
+// interval in ms the reader checks whether it has to stop
+#define IPC_READ_TIMEOUT 200
+
+/**
+ * @brief Subscription to the new blocks (newHeads) of an Ethereum node over
+ * its IPC socket.
+ *
+ * A background thread keeps the subscription open, reconnecting if the node
+ * restarts, and tracks the number of the latest block. Waiting transactions
+ * are checked when a new block arrives instead of polling at a fixed
+ * interval. The subscription is shared by all adapters of the same node.
+ */
+class HeadSubscription {
+ public:
+  /**
+   * @brief Get the subscription of a node, which is shared by all adapters
+   * connected to it
+   *
+   * @param ipc_path Path of the IPC socket of the node (e.g. geth.ipc)
+   * @return Subscription of the node
+   */
+  static auto for_endpoint(const std::string &ipc_path)
+      -> std::shared_ptr<HeadSubscription>;
+
+  /**
+   * @brief Start the background thread subscribing to the node
+   *
+   * @param ipc_path Path of the IPC socket of the node
+   */
+  explicit HeadSubscription(std::string ipc_path);
+
+  //! Stops the background thread
+  ~HeadSubscription();
+
+  HeadSubscription(const HeadSubscription &) = delete;
+  auto operator=(const HeadSubscription &) -> HeadSubscription & = delete;
+
+  //! Whether the subscription is active, i.e. new blocks are reported
+  auto connected() -> bool;
+
+  //! Number of the latest block, 0 if no block arrived yet
+  auto head() -> uint64_t;
+
+  /**
+   * @brief Wait for a block after the given one
+   *
+   * @param seen Number of the latest block known to the caller
+   * @param timeout Maximum time to wait in ms
+   * @return Number of the latest block, equals seen after a timeout
+   */
+  auto wait_for_head(uint64_t seen, size_t timeout) -> uint64_t;
+
+ private:
+  const std::string ipc_path_;
+
+  std::mutex mutex_;
+  std::condition_variable new_head_;
+  uint64_t head_ = 0;
+  bool connected_ = false;
+
+  std::atomic<bool> stop_{false};
+  std::thread reader_;
+
+  //! Connect, subscribe and read notifications until stopped
+  void run();
+
+  //! Read notifications from a connected socket until it is closed
+  void read_notifications(int fd);
+
+  //! Handle a single JSON message of the node
+  void handle_message(const std::string &message);
+};
+#endif  // HEAD_SUBSCRIPTION_H
+/** @} */
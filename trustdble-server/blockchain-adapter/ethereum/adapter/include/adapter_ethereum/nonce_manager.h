@@ -0,0 +1,63 @@
+/** @defgroup group13 nonce_manager
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef NONCE_MANAGER_H
+#define NONCE_MANAGER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief In-process allocator of the transaction nonces of one account.
+ *
+ * The allocator is seeded once with the transaction count of the account on
+ * the chain and hands out consecutive nonces without further requests. It is
+ * shared by all adapters sending from the same account to the same endpoint,
+ * so concurrent transactions never get the same nonce. After a transaction was
+ * rejected (e.g. "nonce too low") the allocator is invalidated and seeded
+ * again on the next allocation.
+ */
+class NonceManager {
+ public:
+  //! Reads the number of transactions of the account from the chain
+  using SEED_FUNCTION = std::function<bool(uint64_t &)>;
+
+  /**
+   * @brief Get the allocator of an account, which is shared by all adapters
+   * sending from it
+   *
+   * @param url Connection-url of the endpoint
+   * @param account Address of the account
+   * @return Allocator of the account
+   */
+  static auto for_account(const std::string &url, const std::string &account)
+      -> std::shared_ptr<NonceManager>;
+
+  /**
+   * @brief Hand out the next nonce of the account
+   *
+   * @param seed Called to read the transaction count of the account if the
+   * allocator is not seeded
+   * @param[out] nonce Allocated nonce
+   * @return true if successfull otherwise false (seeding failed)
+   */
+  auto allocate(const SEED_FUNCTION &seed, uint64_t &nonce) -> bool;
+
+  /**
+   * @brief Drop the local state, so the next allocation seeds the allocator
+   * from the chain again. Called after a transaction was rejected, since its
+   * nonce is either out of sync with the chain or left a gap.
+   */
+  void invalidate();
+
+ private:
+  std::mutex mutex_;
+  bool seeded_ = false;
+  uint64_t next_ = 0;
+};
+#endif  // NONCE_MANAGER_H
+/** @} */
@@ -0,0 +1,86 @@
+/** @defgroup group110 put_batch_encoder
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef PUT_BATCH_ENCODER_H
+#define PUT_BATCH_ENCODER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// share of the block gas limit in percent a single putBatch transaction may use
+#define MAX_BLOCK_GAS_SHARE 90
+// margin in percent added to the gas estimation of a transaction
+#define GAS_ESTIMATE_MARGIN 20
+
+/**
+ * @brief Rows of a put that are written with a single putBatch transaction
+ *
+ */
+struct PutBatchChunk {
+  //! Index of the first row of the chunk
+  size_t begin;
+  //! Index after the last row of the chunk
+  size_t end;
+  //! Gas limit of the transaction
+  uint64_t gas;
+};
+
+/**
+ * @brief Encoder of the putBatch transactions of the trustdble contract.
+ *
+ * The rows of a put are hex-encoded key-value pairs; the encoder splits them
+ * into transactions that fit into a block and ABI-encodes the transactions.
+ * Estimating the gas of a transaction is left to the caller, so the encoder
+ * doesn't depend on an Ethereum node.
+ */
+class PutBatchEncoder {
+ public:
+  /**
+   * @brief Estimates the gas of transactions
+   *
+   * @param data Data of the transactions, encoded with encode()
+   * @return Gas per transaction in the order of data, 0 if the estimation of
+   * a transaction failed
+   */
+  using GasEstimator =
+      std::function<std::vector<uint64_t>(const std::vector<std::string> &)>;
+
+  /**
+   * @brief Split the rows of a put into putBatch transactions. Starting with a
+   * single transaction, the gas of all candidate transactions is estimated at
+   * once; a transaction that needs more than MAX_BLOCK_GAS_SHARE percent of
+   * the block gas limit is split into parts that fit, based on its gas per
+   * row, and estimated again.
+   *
+   * @param rows Hex-encoded keys and values of the put
+   * @param block_gas_limit Gas limit of the latest block
+   * @param contract_version Version of the contract
+   * @param estimate Estimates the gas of the candidate transactions
+   *
+   * @return Chunks covering all rows in their order, with their gas limit
+   */
+  static auto plan(const std::vector<std::pair<std::string, std::string>> &rows,
+                   uint64_t block_gas_limit, uint64_t contract_version,
+                   const GasEstimator &estimate) -> std::vector<PutBatchChunk>;
+
+  /**
+   * @brief ABI-encode a call of putBatch(bytes32[], string[]) or
+   * putBatch(bytes32[], bytes[]), depending on the contract version
+   *
+   * @param rows Hex-encoded keys and values
+   * @param begin Index of the first row to encode
+   * @param end Index after the last row to encode
+   * @param contract_version Version of the contract
+   *
+   * @return Data of the transaction
+   */
+  static auto encode(
+      const std::vector<std::pair<std::string, std::string>> &rows,
+      size_t begin, size_t end, uint64_t contract_version) -> std::string;
+};
+#endif  // PUT_BATCH_ENCODER_H
+/** @} */
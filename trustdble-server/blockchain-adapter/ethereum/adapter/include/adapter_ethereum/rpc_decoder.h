@@ -0,0 +1,119 @@
+/** @defgroup group14 rpc_decoder
+ *  @ingroup group1
+ *  @{
+ */
+#ifndef RPC_DECODER_H
+#define RPC_DECODER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "adapter_interface/adapter_interface.h"
+
+/**
+ * @brief Decoder of JSON-RPC responses and ABI-encoded results of the
+ * trustdble contract.
+ *
+ * All methods work on views of the raw response and scan it once, decoded
+ * values are written directly into the output BYTES without intermediate
+ * strings.
+ */
+class RpcDecoder {
+ public:
+  /**
+   * @brief Find the result of a JSON-RPC response. For a string result the
+   * view covers the string, for an array of strings its first element; a
+   * leading 0x is skipped.
+   *
+   * @param response Raw response of the endpoint
+   * @param[out] result View of the result into response
+   * @return true if the response contains a string result otherwise false
+   * (e.g. an error response)
+   */
+  static auto find_result(std::string_view response, std::string_view &result)
+      -> bool;
+
+  /**
+   * @brief Check whether a JSON-RPC response reports a reverted call, e.g. of
+   * a method the contract does not have. Other errors of the node (rate
+   * limits, missing state, ...) are not reverts.
+   *
+   * @param response Raw response of the endpoint
+   * @return true if the message of the error mentions a revert otherwise
+   * false
+   */
+  static auto is_revert(std::string_view response) -> bool;
+
+  /**
+   * @brief Decode a 32 byte word of an ABI-encoded result as integer
+   *
+   * @param abi Hex-encoded result without 0x
+   * @param offset Offset of the word in bytes
+   * @param[out] value Decoded integer (the low 64 bit of the word)
+   * @return true if successfull otherwise false
+   */
+  static auto decode_uint(std::string_view abi, size_t offset, uint64_t &value)
+      -> bool;
+
+  /**
+   * @brief Decode an ABI-encoded result consisting of a single string, e.g. of
+   * the get method of the contract
+   *
+   * @param abi Hex-encoded result without 0x
+   * @param[out] value Decoded string
+   * @return Status code (0 on success, 1 on failure)
+   */
+  static auto decode_string(std::string_view abi, BYTES &value) -> int;
+
+  /**
+   * @brief Decode the result of the getBatch method of the contract: a list of
+   * keys and the concatenation of their values, each one terminated by
+   * VALUE_SEPARATOR
+   *
+   * @param abi Hex-encoded result without 0x
+   * @param[out] results Decoded key-value pairs are added to this map
+   * @return Number of decoded key-value pairs, -1 on failure
+   */
+  static auto decode_batch(std::string_view abi,
+                           std::map<const BYTES, BYTES> &results) -> int;
+
+  /**
+   * @brief Decode the result of the getBatch method of a version 2 contract: a
+   * list of keys and a list of their values, each one prefixed by its length
+   *
+   * @param abi Hex-encoded result without 0x
+   * @param[out] results Decoded key-value pairs are added to this map
+   * @return Number of decoded key-value pairs, -1 on failure
+   */
+  static auto decode_bytes_batch(std::string_view abi,
+                                 std::map<const BYTES, BYTES> &results) -> int;
+
+  /**
+   * @brief Decode a hex-encoded string into a byte array
+   *
+   * @param hex Hex-encoded string of even length
+   * @param[out] out Array of hex.length() / 2 bytes
+   * @return true if successfull otherwise false (invalid hex digit)
+   */
+  static auto decode_hex(std::string_view hex, unsigned char *out) -> bool;
+
+  //! Separator of the values in a getBatch result ('####' in hex)
+  static constexpr std::string_view VALUE_SEPARATOR = "23232323";
+
+ private:
+  /**
+   * @brief Decode the length-prefixed bytes (or string) at an offset of an
+   * ABI-encoded result
+   *
+   * @param abi Hex-encoded result without 0x
+   * @param offset Offset of the length word in bytes
+   * @param[out] value Decoded bytes
+   * @return true if successfull otherwise false
+   */
+  static auto decode_bytes(std::string_view abi, size_t offset, BYTES &value)
+      -> bool;
+};
+#endif  // RPC_DECODER_H
+/** @} */
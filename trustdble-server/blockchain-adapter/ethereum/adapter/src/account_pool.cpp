@@ -0,0 +1,100 @@
+/*! \addtogroup group17
+ *  @{
+ */
+#include "adapter_ethereum/account_pool.h"
+
+#include <algorithm>
+
+auto AccountPool::for_accounts(const std::string &url,
+                               const std::vector<std::string> &addresses,
+                               size_t max_in_flight)
+    -> std::shared_ptr<AccountPool> {
+  static std::mutex pools_mutex;
+  static std::map<std::string, std::shared_ptr<AccountPool>> pools;
+
+  std::string key = url;
+  for (const auto &address : addresses) {
+    key += "|" + address;
+  }
+
+  std::lock_guard<std::mutex> lock(pools_mutex);
+  auto &pool = pools[key];
+  if (pool == nullptr) {
+    pool = std::make_shared<AccountPool>(url, addresses, max_in_flight);
+  }
+  return pool;
+}
+
+AccountPool::AccountPool(const std::string &url,
+                         const std::vector<std::string> &addresses,
+                         size_t max_in_flight)
+    : max_in_flight_(std::max<size_t>(1, max_in_flight)) {
+  for (const auto &address : addresses) {
+    if (index_.count(address) != 0) {
+      continue;
+    }
+    index_.emplace(address, accounts_.size());
+    // nonces are shared with adapters using the account outside of the pool
+    accounts_.push_back(
+        {address, NonceManager::for_account(url, address), 0});
+  }
+}
+
+auto AccountPool::acquire(size_t count) -> std::vector<std::string> {
+  std::vector<std::string> senders;
+  if (count == 0 || accounts_.empty()) {
+    return senders;
+  }
+
+  auto least_loaded = [this] {
+    return std::min_element(accounts_.begin(), accounts_.end(),
+                            [](const Account &a, const Account &b) {
+                              return a.in_flight < b.in_flight;
+                            });
+  };
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  released_.wait(lock, [&] {
+    return least_loaded()->in_flight < max_in_flight_;
+  });
+  while (senders.size() < count) {
+    auto account = least_loaded();
+    if (account->in_flight >= max_in_flight_) {
+      break;
+    }
+    account->in_flight++;
+    senders.push_back(account->address);
+  }
+  return senders;
+}
+
+void AccountPool::release(const std::vector<std::string> &addresses) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &address : addresses) {
+      auto it = index_.find(address);
+      if (it != index_.end() && accounts_[it->second].in_flight > 0) {
+        accounts_[it->second].in_flight--;
+      }
+    }
+  }
+  released_.notify_all();
+}
+
+auto AccountPool::allocate_nonce(const std::string &address,
+                                 const NonceManager::SEED_FUNCTION &seed,
+                                 uint64_t &nonce) -> bool {
+  auto it = index_.find(address);
+  if (it == index_.end()) {
+    return false;
+  }
+  return accounts_[it->second].nonces->allocate(seed, nonce);
+}
+
+void AccountPool::invalidate(const std::string &address) {
+  auto it = index_.find(address);
+  if (it != index_.end()) {
+    accounts_[it->second].nonces->invalidate();
+  }
+}
+/** @} */
@@ -3,16 +3,16 @@
  */
 #include "adapter_ethereum/adapter_ethereum.h"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+
 #include "adapter_utils/encoding_helpers.h"
-#include "adapter_utils/shell_helpers.h"
 
 /*
  * ---- Ethereum IMPLEMENTATION ----------------------------------
  */
 
-#define START_KEY_ID 0
-#define BATCH_SIZE 100
-
 //! The hash of the put method signature of trustdble ethereum contract
 constexpr static auto kEthereumMethodHashPut = "0xdb82ecc3";
 //! The hash of the get method signature of trustdble ethereum contract
@@ -21,15 +21,23 @@ constexpr static auto kEthereumMethodHashGet = "0x8eaa6ac0";
 constexpr static auto kEthereumMethodHashGetall = "0xb3055e26";
 //! The hash of the remove method signature of trustdble ethereum contract
 constexpr static auto kEthereumMethodHashRemove = "0x95bc2673";
-//! The hash of the putBatch method signature of trustdble ethereum contract
-constexpr static auto kEthereumMethodHashPutBatch = "0x410f08ab";
 //! The hash of the getBatch method signature of trustdble ethereum contract
 constexpr static auto kEthereumMethodHashGetBatch = "0xfe918e68";
+//! The hash of the getSize method signature of trustdble ethereum contract
+constexpr static auto kEthereumMethodHashGetSize = "0xde8fa431";
+//! The hash of the version method signature of version 2 and later
+constexpr static auto kEthereumMethodHashVersion = "0x54fd4d50";
+//! The hash of the lastModified method signature of version 2 and later
+constexpr static auto kEthereumMethodHashLastModified = "0xf7267cfd";
+//! The topic of the Put(bytes32,bytes) event of version 2 and later
+constexpr static auto kEthereumEventTopicPut =
+    "0xb3ec280abdf8699dbf5757d2daf90698d1473dd25bfa71c442b65ec3ac082e61";
+//! The topic of the Remove(bytes32) event of version 2 and later
+constexpr static auto kEthereumEventTopicRemove =
+    "0xa56fb2a6d4126f324526f0668c53927c0cd8e08f41ba0fe0f2d6090a84bc75c8";
 //! The default gas value of 7000000 for transaction in hex
 constexpr static auto kEthereumGas = "0x6ACFC0";
 
-std::mutex EthereumAdapter::m;
-
 // Constructur
 EthereumAdapter::EthereumAdapter() = default;
 
@@ -78,109 +86,83 @@ auto EthereumAdapter::init(const std::string &config_path,
 }
 
 auto EthereumAdapter::shutdown() -> bool {
-  curl_easy_cleanup(curl_);
+  curl_pool_.reset();
   return true;
 }
 
-auto EthereumAdapter::put_batch(std::map<const BYTES, const BYTES> &batch) -> int {
-  // Init of variables
-  std::map<const BYTES, const BYTES>::iterator it;
-  int batch_id = 0;
-  std::string key_string;
-  std::string value_offset;
-  int value_offset_counter = 0;
-  std::string value_string;
-
-  // iterate over all pairs in the batch
-  for (it = batch.begin(); it != batch.end(); it++) {
-
-    // construct the string that holds all keys
-    std::string padded_key = convert_to_32byte(byte_array_to_hex(it->first.value, it->first.size));
-    key_string.append(padded_key);
-
-    // construct value offset string
-    std::string curr_offset = convert_to_32byte(int_to_hex(batch.size()*32+64*value_offset_counter));
-    value_offset.append(curr_offset);
-    value_offset_counter++;
-
-    // construct value string consisting of value length and the respective value
-    std::string val_len = int_to_hex(it->second.size);
-    value_string.append(convert_to_32byte(val_len));
-    value_string.append(convert_to_32byte(byte_array_to_hex(it->second.value, it->second.size)));
-  }
-
-  update_nonce();
-
-  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Put, Nonce is " + std::to_string(nonce_.load());
-  RpcParams params;
-  params.method = "eth_sendTransaction";
-  params.transaction_ID = std::to_string(batch_id++);
-
-  std::string data = int_to_hex(VALUE_SIZE) + int_to_hex(batch.size()*32+96) + int_to_hex(batch.size()) + key_string +
-                     int_to_hex(batch.size()) + value_offset + value_string;
-
-  params.data = kEthereumMethodHashPutBatch + data;
-
-  // Make call to the blockchain to write all elements from the batch as one transaction
-  call(params, true);
-
-  return 0;
-}
-
 auto EthereumAdapter::put(std::map<const BYTES, const BYTES> &batch) -> int {
-  // Init of variables
-  // std::map<const BYTES, const BYTES>::iterator it;
-  std::map<RpcParams, bool> batch_transform;
-  std::map<RpcParams, std::string> key_map;
-  int batch_elem_id = 0;
-
-  // iterate over all pairs in the map
+  if (batch.empty()) {
+    return 0;
+  }
+  std::vector<std::pair<std::string, std::string>> rows;
+  rows.reserve(batch.size());
   for (auto &it : batch) {
-    // update nonce
-    update_nonce();
-    BOOST_LOG_TRIVIAL(debug)
-        << "Ethereum Adapter: Put, Nonce is " + std::to_string(nonce_.load());
-
-    std::string padded_key =
-        convert_to_32byte(byte_array_to_hex(it.first.value, it.first.size));
-    std::string offset = int_to_hex(VALUE_SIZE);
-    std::string val_len = int_to_hex(it.second.size);
-
-    RpcParams params;
-    params.method = "eth_sendTransaction";
-    params.data =
-        std::string(kEthereumMethodHashPut)
-            .append(padded_key)
-            .append(offset)
-            .append(val_len)
-            .append(byte_array_to_hex(it.second.value, it.second.size));
-
-    // Since the transaction ID is not yet set, set it to the value of the
-    // batchElem_ID on an interim basis so that we have a unique key for the
-    // maps
-    params.transaction_ID = std::to_string(batch_elem_id++);
+    rows.emplace_back(byte_array_to_hex(it.first.value, it.first.size),
+                      byte_array_to_hex(it.second.value, it.second.size));
+  }
 
-    // fill the two maps that are the input for the first call function
-    batch_transform.emplace(params, true);
-    key_map.emplace(params, byte_array_to_hex(it.first.value, it.first.size));
+  uint64_t block_gas_limit = 0;
+  if (!get_block_gas_limit(block_gas_limit)) {
+    block_gas_limit = strtoull(kEthereumGas, nullptr, ENCODED_BYTE_SIZE);
   }
+  const std::vector<PutBatchChunk> chunks =
+      plan_put_batches(rows, block_gas_limit);
+  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Put, " << rows.size()
+                           << " rows in " << chunks.size()
+                           << " putBatch transactions";
+
+  const uint64_t contract_version = get_contract_version();
+
+  // the chunks are sent in waves from the accounts of the pool, as many at
+  // once as the accounts have free slots for transactions in flight
+  std::vector<std::string> response;
+  for (size_t next = 0; next < chunks.size();) {
+    const std::vector<std::string> senders =
+        accounts_->acquire(chunks.size() - next);
+
+    std::map<RpcParams, bool> batch_transform;
+    std::map<RpcParams, std::string> chunk_map;
+    for (size_t j = 0; j < senders.size(); j++) {
+      const size_t i = next + j;
+      RpcParams params;
+      params.method = "eth_sendTransaction";
+      params.from = senders[j];
+      params.data = PutBatchEncoder::encode(rows, chunks[i].begin,
+                                            chunks[i].end, contract_version);
+      params.gas = "0x" + int_to_hex(chunks[i].gas, 0);
+      // unique key for the maps until the transaction ID is known
+      params.transaction_ID = std::to_string(i);
+
+      batch_transform.emplace(params, true);
+      chunk_map.emplace(params, std::to_string(i));
+    }
 
-  const auto rpc_batch = createRpcBatch(batch_transform, key_map);
+    const auto rpc_batch = createRpcBatch(batch_transform, chunk_map);
+    const std::vector<std::string> failed_chunks =
+        sendRpcBatch(rpc_batch.first, rpc_batch.second);
+    accounts_->release(senders);
 
-  const std::vector<std::string> response =
-      sendRpcBatch(rpc_batch.first, rpc_batch.second);
+    response.insert(response.end(), failed_chunks.begin(),
+                    failed_chunks.end());
+    next += senders.size();
+  }
 
-  // response contains the keys where the insertion failed
+  // response contains the chunks where the insertion failed
   // using this information, successfully inserted key-value pairs are removed
   // from the batch
   if (!response.empty()) {
-    // std::map<const BYTES, const BYTES>::iterator it;
-
-    for (auto it = batch.begin(); it != batch.end(); it++) {
-      if (std::find(response.begin(), response.end(),
-                    byte_array_to_hex(it->first.value, it->first.size)) ==
-          response.end()) {
-        batch.erase(it->first);
+    std::vector<bool> failed_rows(rows.size(), false);
+    for (const auto &chunk_id : response) {
+      const PutBatchChunk &chunk = chunks[std::stoul(chunk_id)];
+      std::fill(failed_rows.begin() + chunk.begin,
+                failed_rows.begin() + chunk.end, true);
+    }
+    size_t row = 0;
+    for (auto it = batch.begin(); it != batch.end(); row++) {
+      if (!failed_rows[row]) {
+        it = batch.erase(it);
+      } else {
+        ++it;
       }
     }
     return 1;
@@ -201,26 +183,10 @@ auto EthereumAdapter::get(const BYTES &key, BYTES &result) -> int {
   // BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get, Response: " <<
   // response;
 
-  if (response.find("error") == std::string::npos) {
-    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get, Successful!";
-
-    // extract results
-    std::regex rgx(".*\"result\":\"0x(\\w+)\".*");
-    std::smatch match;
-
-    if (std::regex_search(response.begin(), response.end(), match, rgx)) {
-      int val_size =
-          hex_to_int(((std::string)match[1]).substr(VALUE_SIZE, VALUE_SIZE)) *
-          2;
-      result.size =
-          (((std::string)match[1]).substr(2 * VALUE_SIZE, val_size)).length() /
-          2;
-      unsigned char *new_result = new unsigned char[result.size];
-      hex_to_byte_array(
-          (((std::string)match[1]).substr(2 * VALUE_SIZE, val_size)),
-          new_result);
-      result = BYTES(new_result, result.size);
-      delete[] new_result;
+  std::string_view hex_result;
+  if (RpcDecoder::find_result(response, hex_result)) {
+    if (RpcDecoder::decode_string(hex_result, result) == 0) {
+      BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get, Successful!";
       return 0;
     }
     std::string key_str = std::string((const char *)key.value, key.size);
@@ -232,12 +198,44 @@ auto EthereumAdapter::get(const BYTES &key, BYTES &result) -> int {
   return 1;
 }
 
-auto EthereumAdapter::remove(const BYTES &key) -> int {
-  // update nonce
-  update_nonce();
-  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Remove, Nonce is " +
-                                  std::to_string(nonce_.load());
+auto EthereumAdapter::get_batch(const std::vector<BYTES> &keys,
+                                std::map<const BYTES, BYTES> &results) -> int {
+  std::vector<std::pair<std::string, std::string>> requests;
+  requests.reserve(keys.size());
+  for (const auto &key : keys) {
+    RpcParams params;
+    params.from = accountAddress_;
+    params.to = storedContractAddress_;
+    params.data = kEthereumMethodHashGet +
+                  convert_to_32byte(byte_array_to_hex(key.value, key.size));
+    requests.emplace_back("eth_call",
+                          parse_params_to_json(params) + R"(,"latest")");
+  }
+
+  const std::vector<nlohmann::json> responses = call_batch(requests);
+
+  int status = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    const nlohmann::json &response = responses[i];
+    BYTES value;
+    // the contract reverts the call if the key does not exist
+    if (!response.contains("result") || !response["result"].is_string() ||
+        RpcDecoder::decode_string(
+            std::string_view(response["result"].get_ref<const std::string &>())
+                .substr(2),
+            value) != 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Get_Batch, No value found for key: "
+          << byte_array_to_hex(keys[i].value, keys[i].size);
+      status = 1;
+      continue;
+    }
+    results.emplace(BYTES(keys[i].value, keys[i].size), std::move(value));
+  }
+  return status;
+}
 
+auto EthereumAdapter::remove(const BYTES &key) -> int {
   std::string padded_key =
       convert_to_32byte(byte_array_to_hex(key.value, key.size));
   RpcParams params;
@@ -261,45 +259,146 @@ auto EthereumAdapter::remove(const BYTES &key) -> int {
 }
 
 auto EthereumAdapter::get_all(std::map<const BYTES, BYTES> &results) -> int {
-  int key_id = START_KEY_ID;
-  int batch_size = BATCH_SIZE;
-  std::string hex_batch_size = int_to_hex(batch_size);
-
-  bool read_end=false;
-  while(!read_end){
-    std::string hex_key_id = int_to_hex(key_id);
-    key_id=key_id+batch_size;
+  READ_TOKEN token;
+  return get_all_at(results, token);
+}
 
-    RpcParams params;
-    params.method = "eth_call";
-    params.data = kEthereumMethodHashGetBatch+hex_key_id+hex_batch_size;
-    params.quantity_tag = "latest";
+auto EthereumAdapter::get_all_at(std::map<const BYTES, BYTES> &results,
+                                 READ_TOKEN &token) -> int {
+  // read before the pages are fetched concurrently, which decode by it
+  get_contract_version();
+
+  // key ranges (first key, number of keys) of failed pages
+  std::deque<std::pair<uint64_t, uint64_t>> retries;
+  uint64_t next_key_id = 0;
+  uint64_t size = 0;
+  uint64_t block = token.position;
+  ScanCheckpoint checkpoint;
+  if (auto *progress = dynamic_cast<ScanCheckpoint *>(token.progress.get())) {
+    checkpoint = std::move(*progress);
+  }
+  token.progress.reset();
+
+  if (checkpoint.block > 0 && checkpoint.rows == results.size() &&
+      (block == 0 || block == checkpoint.block)) {
+    // continue the interrupted scan of these results
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_All, Resume scan at "
+                                "block "
+                             << checkpoint.block << " with "
+                             << checkpoint.rows << " rows";
+    block = checkpoint.block;
+    size = checkpoint.size;
+    next_key_id = checkpoint.next_key_id;
+    retries.swap(checkpoint.missing);
+  } else {
+    // all pages are read at the same block
+    if (block == 0 && !get_block_number(block)) {
+      return 1;
+    }
+    if (get_size(block, size) != 0) {
+      return 1;
+    }
+  }
 
-    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_All, Response: "
-                              << params.data;
+  const size_t concurrency = std::max(1, config_.scan_concurrency());
+  uint64_t page_size =
+      std::max(1, std::min(config_.scan_page_size(), SCAN_MAX_PAGE_SIZE));
+  size_t scanned_rows = 0;
+  size_t scanned_bytes = 0;
+
+  while (next_key_id < size || !retries.empty()) {
+    // pages of this round, failed ones first
+    std::vector<std::pair<uint64_t, uint64_t>> pages;
+    while (pages.size() < concurrency && !retries.empty()) {
+      pages.push_back(retries.front());
+      retries.pop_front();
+    }
+    while (pages.size() < concurrency && next_key_id < size) {
+      uint64_t keys = std::min(page_size, size - next_key_id);
+      pages.emplace_back(next_key_id, keys);
+      next_key_id += keys;
+    }
 
-    const std::string response = call(params, false);
-    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_All, Response: "
-                              << response;
+    std::vector<std::map<const BYTES, BYTES>> page_results(pages.size());
+    std::vector<size_t> response_sizes(pages.size(), 0);
+    std::vector<int> status(pages.size(), 1);
+    auto start = std::chrono::steady_clock::now();
+    if (pages.size() == 1) {
+      status[0] = get_page(pages[0].first, pages[0].second, block,
+                           page_results[0], response_sizes[0]);
+    } else {
+      std::vector<std::future<int>> fetches;
+      fetches.reserve(pages.size());
+      for (size_t i = 0; i < pages.size(); i++) {
+        fetches.push_back(std::async(std::launch::async, [&, i] {
+          return get_page(pages[i].first, pages[i].second, block,
+                          page_results[i], response_sizes[i]);
+        }));
+      }
+      for (size_t i = 0; i < fetches.size(); i++) {
+        status[i] = fetches[i].get();
+      }
+    }
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    bool failed = false;
+    std::deque<std::pair<uint64_t, uint64_t>> unreadable;
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (status[i] == 0) {
+        scanned_rows += page_results[i].size();
+        scanned_bytes += response_sizes[i];
+        results.merge(page_results[i]);
+        continue;
+      }
+      // e.g. the page needs more gas than an eth_call may use
+      if (pages[i].second == 1) {
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Get_All, Failed to read key "
+            << pages[i].first << " at block " << block;
+        unreadable.push_back(pages[i]);
+        continue;
+      }
+      uint64_t half = pages[i].second / 2;
+      retries.emplace_back(pages[i].first, half);
+      retries.emplace_back(pages[i].first + half, pages[i].second - half);
+      failed = true;
+    }
 
-    std::string rpc_result;
-    try {
-      auto json = nlohmann::json::parse(response);
-      rpc_result = json["result"];
-      rpc_result = rpc_result.substr(2);  // remove 0x from front
-      auto tmp = split(rpc_result);
-      results.insert(tmp.begin(),tmp.end());
-    } catch (std::exception &e) {
-      BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_All, Failed: Can not "
-                                  "parse TableScan response! Error: " << e.what();
-      read_end=true;
+    if (!unreadable.empty()) {
+      // keep the progress, so calling get_all() again only reads the rest
+      unreadable.insert(unreadable.end(), retries.begin(), retries.end());
+      auto progress = std::make_unique<ScanCheckpoint>();
+      progress->block = block;
+      progress->size = size;
+      progress->next_key_id = next_key_id;
+      progress->missing.swap(unreadable);
+      progress->rows = results.size();
+      token.progress = std::move(progress);
+      return 1;
     }
-  }
 
-  if (results.empty()) {
-    return 1;
+    // aim for SCAN_TARGET_PAGE_BYTES per page: grow at most by factor two per
+    // round as long as the pages are fast enough, shrink if pages fail
+    if (failed) {
+      page_size = std::max<uint64_t>(1, page_size / 2);
+    } else if (scanned_rows > 0) {
+      uint64_t row_bytes = std::max<size_t>(1, scanned_bytes / scanned_rows);
+      uint64_t target = std::max<uint64_t>(
+          1, std::min<uint64_t>(SCAN_TARGET_PAGE_BYTES / row_bytes,
+                                SCAN_MAX_PAGE_SIZE));
+      if (latency <= SCAN_MAX_PAGE_LATENCY) {
+        page_size = std::min(target, page_size * 2);
+      } else {
+        page_size = std::min(target, page_size);
+      }
+    }
   }
 
+  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_All, Read "
+                           << scanned_rows << " rows of " << size
+                           << " at block " << block;
   return 0;
 }
 
@@ -309,26 +408,26 @@ auto EthereumAdapter::create_table(const std::string &name,
     return 1;
   }
 
-  // Deploy Contract
-  std::string cmd = "node " + config_.script_path() +
-                    "/deploy_KV_contract.js " + accountAddress_ + " " +
-                    config_.contract_path() + " " + config_.connection_url();
-  tableAddress = exec(cmd.c_str());
+  // claim a pre-deployed contract or deploy a new one
+  tableAddress.clear();
+  if (contract_pool_ == nullptr || !contract_pool_->claim(tableAddress)) {
+    std::vector<std::string> deployed;
+    if (deploy_contracts(1, deployed) != 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Create_Table, Deployment failed for table: "
+          << name;
+      return 1;
+    }
+    tableAddress = deployed.front();
+  }
   storedContractAddress_ = tableAddress;
   tableName_ = name;
+  contract_version_.value = 0;
 
   BOOST_LOG_TRIVIAL(debug)
       << "Ethereum Adapter: Create_Table, Contract Address: "
       << storedContractAddress_ << " for table: " << tableName_;
 
-  // init nonce
-  if (nonce_ == 0) {
-    update_nonce();
-  }
-
-  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Create_Table, Nonce is " +
-                                  std::to_string(nonce_.load());
-
   return 0;
 }
 
@@ -336,6 +435,7 @@ auto EthereumAdapter::load_table(const std::string &name,
                                  const std::string &tableAddress) -> int {
   if (!tableAddress.empty()) {
     storedContractAddress_ = tableAddress;
+    contract_version_.value = 0;
   } else {
     BOOST_LOG_TRIVIAL(debug)
         << "Ethereum Adapter: Load_Table, tableAddress is empty!";
@@ -348,14 +448,6 @@ auto EthereumAdapter::load_table(const std::string &name,
                            << storedContractAddress_
                            << " for table: " << tableName_;
 
-  // init nonce
-  if (nonce_ == 0) {
-    update_nonce();
-  }
-
-  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Load_Table, Nonce is " +
-                                  std::to_string(nonce_.load());
-
   return 0;
 }
 
@@ -372,6 +464,138 @@ auto EthereumAdapter::drop_table() -> int {
   return 0;
 }
 
+auto EthereumAdapter::get_version(READ_TOKEN &token) -> int {
+  uint64_t version = 0;
+  uint64_t block = 0;
+  if (get_contract_version() >= 2) {
+    // the block of the last modification and the latest block in one request
+    RpcParams params;
+    params.to = storedContractAddress_;
+    params.data = kEthereumMethodHashLastModified;
+    const std::vector<nlohmann::json> responses = call_batch(
+        {{"eth_call", parse_params_to_json(params) + R"(,"latest")"},
+         {"eth_blockNumber", ""}});
+    try {
+      std::string_view result(
+          responses[0].at("result").get_ref<const std::string &>());
+      if (!RpcDecoder::decode_uint(result.substr(2), 0, version)) {
+        throw std::invalid_argument("invalid lastModified result");
+      }
+      auto hex_number =
+          responses[1].at("result").get<std::string>().substr(2);  // 0x
+      block = strtoull(hex_number.c_str(), nullptr, ENCODED_BYTE_SIZE);
+    } catch (std::exception &e) {
+      BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Version, Failed: "
+                                  "Can not read lastModified! Error: "
+                               << e.what();
+      return 1;
+    }
+    // the call may have been executed at a newer block than the block number
+    block = std::max(block, version);
+  } else {
+    if (!get_block_number(block)) {
+      return 1;
+    }
+    version = block;
+  }
+
+  // table scans with the token read the table as of this version
+  token.version = version;
+  token.position = block;
+  token.progress.reset();
+  return 0;
+}
+
+auto EthereumAdapter::get_changes(uint64_t since, const READ_TOKEN &token,
+                                  std::map<const BYTES, BYTES> &puts,
+                                  std::vector<BYTES> &removes) -> int {
+  // only version 2 contracts emit events, their versions are blocks
+  const uint64_t block = token.position;
+  if (block == 0 || get_contract_version() < 2) {
+    return 1;
+  }
+
+  std::vector<std::pair<std::string, std::string>> requests;
+  for (uint64_t from = since + 1; from <= block; from += MAX_LOG_BLOCK_RANGE) {
+    const uint64_t to = std::min(block, from + MAX_LOG_BLOCK_RANGE - 1);
+    nlohmann::json filter = {
+        {"address", storedContractAddress_},
+        {"fromBlock", "0x" + int_to_hex(from, 0)},
+        {"toBlock", "0x" + int_to_hex(to, 0)},
+        {"topics",
+         {{kEthereumEventTopicPut, kEthereumEventTopicRemove}}}};
+    requests.emplace_back("eth_getLogs", filter.dump());
+  }
+  const std::vector<nlohmann::json> responses = call_batch(requests);
+
+  // the logs are ordered by block and position in the block, later changes
+  // of a key replace earlier ones
+  std::set<BYTES> removed;
+  size_t num_logs = 0;
+  try {
+    for (const auto &response : responses) {
+      for (const auto &log : response.at("result")) {
+        const auto &topics = log.at("topics");
+        const auto &topic = topics.at(0).get_ref<const std::string &>();
+        std::string_view key_topic(
+            topics.at(1).get_ref<const std::string &>());
+        BYTES key(VALUE_SIZE / 2);
+        if (key_topic.size() != VALUE_SIZE + 2 ||
+            !RpcDecoder::decode_hex(key_topic.substr(2), key.value)) {
+          throw std::invalid_argument("invalid key topic");
+        }
+
+        if (topic == kEthereumEventTopicPut) {
+          std::string_view data(log.at("data").get_ref<const std::string &>());
+          BYTES value;
+          if (RpcDecoder::decode_string(data.substr(2), value) != 0) {
+            throw std::invalid_argument("invalid Put data");
+          }
+          removed.erase(key);
+          puts.insert_or_assign(std::move(key), std::move(value));
+        } else if (topic == kEthereumEventTopicRemove) {
+          puts.erase(key);
+          removed.insert(std::move(key));
+        }
+        num_logs++;
+      }
+    }
+  } catch (std::exception &e) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Changes, Failed: Can "
+                                "not read the logs since block "
+                             << since << "! Error: " << e.what();
+    return 1;
+  }
+
+  for (const auto &key : removed) {
+    removes.push_back(key);
+  }
+  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Changes, " << num_logs
+                           << " events between block " << since
+                           << " and block " << block << ": " << puts.size()
+                           << " puts, " << removes.size() << " removes";
+  return 0;
+}
+
+auto EthereumAdapter::get_block_number(uint64_t &block) -> bool {
+  std::string params;
+  std::string method = "eth_blockNumber";
+  const std::string response = call(params, method);
+
+  try {
+    auto json = nlohmann::json::parse(response);
+    auto hex_number = json.at("result").get<std::string>().substr(2);  // 0x
+    block = strtoull(hex_number.c_str(), nullptr, ENCODED_BYTE_SIZE);
+  } catch (std::exception &e) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Block_Number, Failed: "
+                                "Can not parse eth_blockNumber response! "
+                                "Error: "
+                             << e.what();
+    return false;
+  }
+  return true;
+}
+
 /*
  * ---- HELPER METHODS ----------------------------------
  */
@@ -421,37 +645,174 @@ auto EthereumAdapter::verify_network_config(const std::string &network_config)
   return true;
 }
 
-auto EthereumAdapter::update_nonce() -> bool {
+auto EthereumAdapter::get_size(uint64_t block, uint64_t &size) -> int {
   RpcParams params;
-  params.method = "eth_getTransactionCount";
+  params.method = "eth_call";
+  params.data = kEthereumMethodHashGetSize;
+  params.quantity_tag = "0x" + int_to_hex(block, 0);
+
+  const std::string response = call(params, false);
+  std::string_view hex_result;
+  if (!RpcDecoder::find_result(response, hex_result) ||
+      !RpcDecoder::decode_uint(hex_result, 0, size)) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Size, Failed: "
+                             << response;
+    return 1;
+  }
+  return 0;
+}
+
+auto EthereumAdapter::get_contract_version() -> uint64_t {
+  const uint64_t cached = contract_version_.value.load();
+  if (cached > 0) {
+    return cached;
+  }
+
+  RpcParams params;
+  params.method = "eth_call";
+  params.data = kEthereumMethodHashVersion;
   params.quantity_tag = "latest";
-  std::string param = "\"" + accountAddress_ + R"(", "latest")";
+
+  const std::string response = call(params, false);
+  std::string_view hex_result;
+  uint64_t version = 0;
+  if (RpcDecoder::find_result(response, hex_result) &&
+      RpcDecoder::decode_uint(hex_result, 0, version) && version > 0) {
+    contract_version_.value = version;
+  } else if (RpcDecoder::is_revert(response)) {
+    // the first contract has no version method, its call reverts
+    version = 1;
+    contract_version_.value = version;
+  } else {
+    // unreachable node or transient error, try again with the next request
+    BOOST_LOG_TRIVIAL(debug)
+        << "Ethereum Adapter: Get_Contract_Version, Failed: " << response;
+    return 1;
+  }
+
+  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Contract_Version, "
+                           << storedContractAddress_ << " is version "
+                           << version;
+  return version;
+}
+
+auto EthereumAdapter::get_page(uint64_t key_id, uint64_t page_size,
+                               uint64_t block,
+                               std::map<const BYTES, BYTES> &results,
+                               size_t &response_size) -> int {
+  RpcParams params;
+  params.method = "eth_call";
+  params.data =
+      kEthereumMethodHashGetBatch + int_to_hex(key_id) + int_to_hex(page_size);
+  params.quantity_tag = "0x" + int_to_hex(block, 0);
+
+  const bool length_prefixed = get_contract_version() >= 2;
+  const std::string response = call(params, false);
+  response_size = response.size();
+
+  std::string_view rpc_result;
+  if (!RpcDecoder::find_result(response, rpc_result) ||
+      (length_prefixed ? RpcDecoder::decode_bytes_batch(rpc_result, results)
+                       : RpcDecoder::decode_batch(rpc_result, results)) < 0) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Page, Failed: Can not "
+                                "parse TableScan response of "
+                             << page_size << " keys from " << key_id;
+    return 1;
+  }
+  return 0;
+}
+
+auto EthereumAdapter::get_block_gas_limit(uint64_t &gas_limit) -> bool {
+  std::string param = R"("latest", false)";
+  std::string method = "eth_getBlockByNumber";
+
+  auto response = call(param, method);
+  try {
+    auto json = nlohmann::json::parse(response);
+    auto hex_limit =
+        json.at("result").at("gasLimit").get<std::string>().substr(2);  // 0x
+    gas_limit = strtoull(hex_limit.c_str(), nullptr, ENCODED_BYTE_SIZE);
+  } catch (std::exception &) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Block_Gas_Limit, "
+                                "Failed: Can not parse "
+                                "eth_getBlockByNumber response!";
+    return false;
+  }
+  return gas_limit > 0;
+}
+
+auto EthereumAdapter::plan_put_batches(
+    const std::vector<std::pair<std::string, std::string>> &rows,
+    uint64_t block_gas_limit) -> std::vector<PutBatchChunk> {
+  auto estimate = [this](const std::vector<std::string> &data) {
+    std::vector<std::pair<std::string, std::string>> requests;
+    requests.reserve(data.size());
+    for (const auto &transaction : data) {
+      RpcParams params;
+      params.from = accountAddress_;
+      params.to = storedContractAddress_;
+      params.data = transaction;
+      requests.emplace_back("eth_estimateGas", parse_params_to_json(params));
+    }
+    const std::vector<nlohmann::json> estimations = call_batch(requests);
+
+    std::vector<uint64_t> gas(data.size(), 0);
+    for (size_t i = 0; i < data.size() && i < estimations.size(); i++) {
+      if (estimations[i].contains("result") &&
+          estimations[i]["result"].is_string()) {
+        gas[i] = strtoull(
+            estimations[i]["result"].get<std::string>().substr(2).c_str(),
+            nullptr, ENCODED_BYTE_SIZE);
+      } else {
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Plan_Put_Batches, Estimation failed: "
+            << estimations[i].dump();
+      }
+    }
+    return gas;
+  };
+  return PutBatchEncoder::plan(rows, block_gas_limit, get_contract_version(),
+                               estimate);
+}
+
+auto EthereumAdapter::get_transaction_count(const std::string &address,
+                                            uint64_t &count) -> bool {
+  // include pending transactions, they already used their nonces
+  std::string param = "\"" + address + R"(", "pending")";
   std::string method = "eth_getTransactionCount";
 
   auto response = call(param, method);
   try {
     auto json = nlohmann::json::parse(response);
-    auto hex_count = json["result"].get<std::string>().substr(2);  // remove 0x
-    auto tmp_nonce = strtoul(hex_count.c_str(), nullptr, ENCODED_BYTE_SIZE);
-    tmp_nonce = std::max((unsigned long)0, tmp_nonce - 1);  // nonce starts at 0
-    nonce_.store(tmp_nonce);
+    auto hex_count = json.at("result").get<std::string>().substr(2);  // 0x
+    count = strtoull(hex_count.c_str(), nullptr, ENCODED_BYTE_SIZE);
   } catch (std::exception &) {
-    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Update Nonce, Failed: Can "
-                                "not parse eth_getTransactionCount response!";
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Get_Transaction_Count, "
+                                "Failed: Can not parse "
+                                "eth_getTransactionCount response!";
+    return false;
   }
+  BOOST_LOG_TRIVIAL(debug)
+      << "Ethereum Adapter: Get_Transaction_Count, Nonce of " << address
+      << " is " << count;
   return true;
 }
 
+auto EthereumAdapter::allocate_nonce(const std::string &address,
+                                     uint64_t &nonce) -> bool {
+  return accounts_->allocate_nonce(
+      address,
+      [this, &address](uint64_t &count) {
+        return get_transaction_count(address, count);
+      },
+      nonce);
+}
+
 auto EthereumAdapter::init() -> bool {
   /// \cond
   this->max_waiting_time_ =
       config_.max_waiting_time() * WAITING_TIME_IN_SEC;  // convert to ms
-  m.lock();
-  curl_ = curl_easy_init();
-  curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
-  curl_easy_setopt(curl_, CURLOPT_URL, config_.connection_url().c_str());
-  curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
-  m.unlock();
+  curl_pool_ = CurlPool::for_endpoint(config_.connection_url());
   RpcParams params;
   params.method = "eth_accounts";
 
@@ -463,21 +824,49 @@ auto EthereumAdapter::init() -> bool {
     BOOST_LOG_TRIVIAL(debug)
         << "Ethereum Adapter: Init, ListAccounts successful: " << response;
 
-    // extract result
-    std::regex rgx(".*\"result\":\\[\"(\\w+)\".*");
-    std::smatch match;
-
-    if (std::regex_search(response.begin(), response.end(), match, rgx)) {
-      accountAddress_ = (std::string)match[1];
-      BOOST_LOG_TRIVIAL(debug)
-          << "Ethereum Adapter: Init, Set account to " << accountAddress_;
-    } else {
+    // extract result, the account of the adapter is the first one of the
+    // list, transactions are sent from the first sender-accounts ones
+    std::vector<std::string> senders;
+    try {
+      auto accounts = nlohmann::json::parse(response).at("result");
+      const size_t num_senders =
+          std::max(1, std::min<int>(config_.sender_accounts(),
+                                    static_cast<int>(accounts.size())));
+      for (size_t i = 0; i < num_senders && i < accounts.size(); i++) {
+        senders.push_back(accounts[i].get<std::string>());
+      }
+    } catch (nlohmann::detail::exception &) {
+    }
+    if (senders.empty()) {
       BOOST_LOG_TRIVIAL(debug)
           << "Ethereum Adapter: Init, No result for accounts";
       return false;
     }
+    accountAddress_ = senders.front();
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Init, Set account to "
+                             << accountAddress_ << ", " << senders.size()
+                             << " sender accounts";
 
-    nonce_ = 0;
+    accounts_ = AccountPool::for_accounts(config_.connection_url(), senders,
+                                          config_.max_pending_transactions());
+
+    if (!config_.ipc_path().empty()) {
+      heads_ = HeadSubscription::for_endpoint(config_.ipc_path());
+    }
+
+    if (config_.contract_pool_size() > 0) {
+      contract_pool_ = ContractPool::for_contract(
+          config_.connection_url() + "|" + config_.contract_path() + "|" +
+              accountAddress_,
+          config_.contract_pool_size(), [this] {
+            // the pool outlives the adapter, it deploys with a copy of it
+            auto deployer = std::make_shared<EthereumAdapter>(*this);
+            return [deployer](size_t count,
+                              std::vector<std::string> &addresses) {
+              return deployer->deploy_contracts(count, addresses);
+            };
+          });
+    }
 
     return true;
   }
@@ -495,71 +884,6 @@ auto EthereumAdapter::convert_to_32byte(const std::string &data)
   return ss.str().substr(0, VALUE_SIZE);
 }
 
-auto EthereumAdapter::split(const std::string &response, int split_length)
-    -> std::map<const BYTES, BYTES> {
-  std::map<const BYTES, BYTES> ret;
-  std::vector<std::string> keys;
-  std::vector<std::string> values;
-
-  if (!response.empty()) {
-    unsigned long num_keys_values = hex_to_int(response.substr(
-        split_length * 2,
-        split_length));  // *2 to skip first 2 rows of meta data in response
-
-    keys.reserve(num_keys_values);
-    values.reserve(num_keys_values);
-
-    // get keys
-    for (unsigned long i = 0; i < num_keys_values; i++) {
-      keys.push_back(response.substr(
-          ((i + 3) * split_length),
-          split_length));  // +3 to skip rows including meta-data
-    }
-
-    // get values
-    std::string parsed_values =
-        response.substr((num_keys_values + 4) *
-                        split_length);  // +4 to skip rows including meta-data
-
-    // split values by token
-    std::string result = parsed_values;
-    std::string token = "23232323";  // '####' in hex
-    std::string value;
-
-    while (static_cast<unsigned int>(!result.empty()) != 0U) {
-      auto index = result.find(token);
-      if (index != std::string::npos) {
-        // get value
-        values.push_back(result.substr(0, index));
-        result = result.substr(index + token.size());
-      } else {
-        break;
-      }
-    }
-
-    // fill result vector with keys and values
-    for (unsigned long i = 0; i < num_keys_values; i++) {
-      unsigned char *key = new unsigned char[keys.at(i).length() / 2];
-      unsigned char *value = new unsigned char[values.at(i).length() / 2];
-      hex_to_byte_array(keys.at(i), key);
-      hex_to_byte_array(values.at(i), value);
-      BYTES key_byte(key, keys.at(i).length() / 2);
-      BYTES value_byte(value, values.at(i).length() / 2);
-
-      ret.emplace(key_byte, value_byte);
-      delete[] key;
-      delete[] value;
-    }
-  }
-  return ret;
-}
-
-auto EthereumAdapter::write_callback(char *contents, size_t size, size_t nmemb,
-                                     void *userp) -> size_t {
-  ((std::string *)userp)->append(contents, size * nmemb);
-  return size * nmemb;
-}
-
 auto EthereumAdapter::parse_params_to_json(const RpcParams &params)
     -> std::string {
   std::vector<std::string> els;
@@ -581,7 +905,7 @@ auto EthereumAdapter::parse_params_to_json(const RpcParams &params)
   if (!params.gas_price.empty()) {
     els.push_back(R"("gasPrice":")" + params.gas_price + "\"");
   }
-  if (params.nonce > 0) {
+  if (params.has_nonce) {
     std::stringstream ss;
     ss << "0x";
     ss << int_to_hex(params.nonce, 0);  // set to 0 to have no leading zeros
@@ -600,9 +924,17 @@ auto EthereumAdapter::parse_params_to_json(const RpcParams &params)
 }
 
 auto EthereumAdapter::call(RpcParams params, bool set_gas) -> std::string {
-  std::string from_address = accountAddress_;
-
-  params.from = from_address;
+  if (params.method == "eth_sendTransaction" && params.from.empty()) {
+    // send from the least busy account, until the transaction is mined
+    const std::vector<std::string> sender = accounts_->acquire(1);
+    params.from = sender.front();
+    std::string response = call(params, set_gas);
+    accounts_->release(sender);
+    return response;
+  }
+  if (params.from.empty()) {
+    params.from = accountAddress_;
+  }
   if (params.to.empty()) {
     params.to = storedContractAddress_;
   }
@@ -610,10 +942,15 @@ auto EthereumAdapter::call(RpcParams params, bool set_gas) -> std::string {
     params.gas = kEthereumGas;
   }
 
-  // Increment nonce to indicate that Ethereum should not replace a currently
+  // A new nonce indicates that Ethereum should not replace a currently
   // pending transaction, but add as new transaction
   if (params.method == "eth_sendTransaction") {
-    params.nonce = ++nonce_;
+    uint64_t nonce = 0;
+    if (!allocate_nonce(params.from, nonce)) {
+      return "error";
+    }
+    params.nonce = nonce;
+    params.has_nonce = true;
   }
 
   std::string json = parse_params_to_json(params);
@@ -621,50 +958,106 @@ auto EthereumAdapter::call(RpcParams params, bool set_gas) -> std::string {
       params.quantity_tag.empty() ? "" : ",\"" + params.quantity_tag + "\"";
   json = json + quantity_tag;
 
-  std::string response;
-
+  if (params.method == "eth_sendTransaction") {
+    // send the transaction and wait until it is mined
+    std::string transaction_id = send_transaction(json, params.from);
+    if (transaction_id.empty() || !await_receipts({transaction_id}).empty()) {
+      return "error";
+    }
+    return transaction_id;
+  }
   return call(json, params.method);
 }
 
 auto EthereumAdapter::call(std::string &params, std::string &method)
     -> std::string {
-  std::string read_buffer_call;
   const std::string post_data = R"({"jsonrpc":"2.0","id":1,"method":")" +
                                 method + R"(","params":[)" + params + "]}";
-  std::string read_buffer;
-
-  if (curl_ != nullptr) {
-    struct curl_slist *headers = nullptr;
+  return post(post_data);
+}
 
-    m.lock();
-    headers = curl_slist_append(headers, "Content-Type: application/json");
+auto EthereumAdapter::post(const std::string &post_data) -> std::string {
+  std::string read_buffer_call;
 
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &read_buffer_call);
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, post_data.c_str());
-    CURLcode res = curl_easy_perform(curl_);
-    m.unlock();
+  if (curl_pool_ != nullptr) {
+    CURLcode res = curl_pool_->post(post_data, read_buffer_call);
     if (res != CURLE_OK) {
       auto msg = "CURL perform() returned an error: " +
                  std::string(curl_easy_strerror(res));
       BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Call, " << msg;
     }
+  }
+  return read_buffer_call;
+}
+
+auto EthereumAdapter::call_batch(
+    const std::vector<std::pair<std::string, std::string>> &requests)
+    -> std::vector<nlohmann::json> {
+  std::vector<nlohmann::json> responses(requests.size());
+
+  for (size_t begin = 0; begin < requests.size();
+       begin += MAX_RPC_BATCH_SIZE) {
+    const size_t end = std::min(requests.size(), begin + MAX_RPC_BATCH_SIZE);
+
+    // the id of a request is its index in requests
+    std::string post_data = "[";
+    for (size_t i = begin; i < end; i++) {
+      if (i > begin) {
+        post_data += ",";
+      }
+      post_data += R"({"jsonrpc":"2.0","id":)" + std::to_string(i) +
+                   R"(,"method":")" + requests[i].first + R"(","params":[)" +
+                   requests[i].second + "]}";
+    }
+    post_data += "]";
+    const std::string response = post(post_data);
 
-    if (method == "eth_sendTransaction") {
-      nlohmann::json json_response;
-      parseTX_response(read_buffer_call, json_response);
-      auto transaction_id = json_response["result"].get<std::string>();
-      BOOST_LOG_TRIVIAL(debug)
-          << "Ethereum Adapter: Call, Transaction-ID: " << transaction_id;
-      read_buffer = check_mining_result(transaction_id);
-      if (!check_transaction_receipt(transaction_id)) {
-        read_buffer = "error";
+    try {
+      nlohmann::json json_response = nlohmann::json::parse(response);
+      if (!json_response.is_array()) {
+        // e.g. the endpoint rejected the batch as a whole
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Call_Batch, Batch failed: " << response;
+        continue;
       }
-    } else {
-      read_buffer = read_buffer_call;
+      for (auto &single_response : json_response) {
+        if (!single_response.contains("id") ||
+            !single_response["id"].is_number_unsigned()) {
+          continue;
+        }
+        auto id = single_response["id"].get<size_t>();
+        if (id >= begin && id < end) {
+          responses[id] = std::move(single_response);
+        }
+      }
+    } catch (nlohmann::detail::exception &e) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Call_Batch, Can't parse response " << response
+          << " Error: " << e.what();
     }
   }
-  return read_buffer;
+  return responses;
+}
+
+auto EthereumAdapter::send_transaction(const std::string &params,
+                                       const std::string &from) -> std::string {
+  const std::string post_data =
+      R"({"jsonrpc":"2.0","id":1,"method":"eth_sendTransaction","params":[)" +
+      params + "]}";
+  const std::string read_buffer_call = post(post_data);
+
+  nlohmann::json json_response;
+  parseTX_response(read_buffer_call, json_response);
+  if (!json_response.contains("result") ||
+      !json_response["result"].is_string()) {
+    // the nonce of the transaction is unused now, get in sync again
+    accounts_->invalidate(from);
+    return "";
+  }
+  auto transaction_id = json_response["result"].get<std::string>();
+  BOOST_LOG_TRIVIAL(debug)
+      << "Ethereum Adapter: Call, Transaction-ID: " << transaction_id;
+  return transaction_id;
 }
 
 void EthereumAdapter::parseTX_response(const std::string &read_buffer_call,
@@ -688,70 +1081,179 @@ void EthereumAdapter::parseTX_response(const std::string &read_buffer_call,
   }
 }
 
-auto EthereumAdapter::check_mining_result(std::string &transaction_ID)
-    -> std::string {
-  std::string response;
+auto EthereumAdapter::await_receipts(
+    const std::vector<std::string> &transaction_IDs,
+    std::map<std::string, nlohmann::json> *mined_receipts)
+    -> std::set<std::string> {
+  std::set<std::string> failed;
+  std::vector<std::string> pending;
+  for (const auto &transaction_ID : transaction_IDs) {
+    // transactions that were rejected when sending have no ID
+    if (transaction_ID.empty()) {
+      failed.insert(transaction_ID);
+    } else {
+      pending.push_back(transaction_ID);
+    }
+  }
   size_t waited = 0;
 
-  while ((waited + MINING_CHECK_INTERVAL) < this->max_waiting_time_) {
-    std::this_thread::sleep_for(
-        std::chrono::milliseconds(MINING_CHECK_INTERVAL));
-    std::string transaction_param = "\"" + transaction_ID + "\"";
-    std::string method = "eth_getTransactionByHash";
-    response = call(transaction_param, method);
-
-    try {
-      nlohmann::json json_response = nlohmann::json::parse(response);
-
-      if (!(json_response.at("result").at("blockNumber").is_null())) {
-        std::stringstream msg;
-        msg << "Mining took about " << waited << " ms";
+  // with new blocks being reported, check right away (e.g. a dev-mode node
+  // mines instantly) and then once per block instead of polling
+  bool check_now = heads_ != nullptr && heads_->connected();
+  uint64_t head = check_now ? heads_->head() : 0;
+
+  while (!pending.empty() &&
+         (waited + MINING_CHECK_INTERVAL) < this->max_waiting_time_) {
+    if (!check_now) {
+      auto wait_start = std::chrono::steady_clock::now();
+      if (heads_ != nullptr && heads_->connected()) {
+        head = heads_->wait_for_head(
+            head, std::min<size_t>(MINING_CHECK_MAX_INTERVAL,
+                                   this->max_waiting_time_ - waited));
+      } else {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(MINING_CHECK_INTERVAL));
+      }
+      waited += std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - wait_start)
+                    .count();
+    }
+    check_now = false;
+
+    // request the receipts of all pending transactions at once
+    std::vector<std::pair<std::string, std::string>> requests;
+    requests.reserve(pending.size());
+    for (const auto &transaction_ID : pending) {
+      requests.emplace_back("eth_getTransactionReceipt",
+                            "\"" + transaction_ID + "\"");
+    }
+    const std::vector<nlohmann::json> receipts = call_batch(requests);
+
+    std::vector<bool> mined(pending.size(), false);
+    for (size_t i = 0; i < pending.size(); i++) {
+      // a receipt is null until the transaction is mined, a missing response
+      // is retried with the next poll
+      if (!receipts[i].contains("result") || receipts[i]["result"].is_null()) {
+        continue;
+      }
+      mined[i] = true;
+      if (receipts[i]["result"].value("status", "") != "0x1") {
         BOOST_LOG_TRIVIAL(debug)
-            << "Ethereum Adapter: check_mining_result, " << msg.str();
-        return response;
+            << "Ethereum Adapter: await_receipts, Transaction failed: "
+            << receipts[i].dump();
+        failed.insert(pending[i]);
+      } else if (mined_receipts != nullptr) {
+        mined_receipts->emplace(pending[i], std::move(receipts[i]["result"]));
       }
-    } catch (nlohmann::detail::exception &) {
-      BOOST_LOG_TRIVIAL(debug)
-          << "Ethereum Adapter: check_mining_result, Can't parse response"
-          << response;
-      // continue, so try again
     }
 
-    waited += MINING_CHECK_INTERVAL;
+    std::vector<std::string> still_pending;
+    for (size_t i = 0; i < pending.size(); i++) {
+      if (!mined[i]) {
+        still_pending.push_back(pending[i]);
+      }
+    }
+    pending.swap(still_pending);
   }
 
-  return response;
+  if (!pending.empty()) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: await_receipts, "
+                             << pending.size()
+                             << " transactions not mined after " << waited
+                             << " ms";
+    failed.insert(pending.begin(), pending.end());
+  }
+  BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: await_receipts, Mining took "
+                              "about "
+                           << waited << " ms";
+  return failed;
 }
 
-auto EthereumAdapter::check_transaction_receipt(std::string &transaction_ID)
-    -> bool {
-  std::string method = "eth_getTransactionReceipt";
-  std::string transaction_param = "\"" + transaction_ID + "\"";
-  std::string response = call(transaction_param, method);
-
+auto EthereumAdapter::deploy_contracts(size_t count,
+                                       std::vector<std::string> &addresses)
+    -> int {
+  std::string bytecode;
   try {
-    nlohmann::json json_response = nlohmann::json::parse(response);
-    BOOST_LOG_TRIVIAL(debug)
-        << "Ethereum Adapter: check_transaction_receipt, Status: "
-        << json_response.at("result").at("status").get<std::string>();
-    if (json_response.at("result").at("status").get<std::string>() == "0x1") {
-      return true;
+    std::ifstream contract_file(config_.contract_path());
+    bytecode = nlohmann::json::parse(contract_file)
+                   .at("bytecode")
+                   .get<std::string>();
+  } catch (std::exception &e) {
+    BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Deploy_Contracts, Can not "
+                                "read bytecode from "
+                             << config_.contract_path() << ": " << e.what();
+    return 1;
+  }
+
+  // all deployments of the contract need the same gas
+  RpcParams deployment;
+  deployment.from = accountAddress_;
+  deployment.data = bytecode;
+  std::string params = parse_params_to_json(deployment);
+  std::string method = "eth_estimateGas";
+  const std::string estimation = call(params, method);
+  std::string_view hex_gas;
+  deployment.gas = kEthereumGas;
+  if (RpcDecoder::find_result(estimation, hex_gas)) {
+    const uint64_t gas =
+        strtoull(std::string(hex_gas).c_str(), nullptr, ENCODED_BYTE_SIZE);
+    deployment.gas =
+        "0x" + int_to_hex(gas * (100 + GAS_ESTIMATE_MARGIN) / 100, 0);
+  }
+
+  const size_t deployed_before = addresses.size();
+  for (size_t next = 0; next < count;) {
+    const std::vector<std::string> senders = accounts_->acquire(count - next);
+
+    std::vector<std::pair<std::string, std::string>> requests;
+    for (const auto &sender : senders) {
+      RpcParams params = deployment;
+      params.from = sender;
+      uint64_t nonce = 0;
+      if (allocate_nonce(sender, nonce)) {
+        params.nonce = nonce;
+        params.has_nonce = true;
+      }
+      requests.emplace_back("eth_sendTransaction",
+                            parse_params_to_json(params));
     }
-  } catch (nlohmann::detail::exception &e) {
-    BOOST_LOG_TRIVIAL(debug)
-        << "EthereumAdapter: check_transaction_receipt, Can't parse response"
-        << e.what();
+    const std::vector<nlohmann::json> responses = call_batch(requests);
+
+    std::vector<std::string> transaction_IDs;
+    for (size_t i = 0; i < senders.size(); i++) {
+      if (responses[i].contains("result") &&
+          responses[i]["result"].is_string()) {
+        transaction_IDs.push_back(responses[i]["result"].get<std::string>());
+      } else {
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Deploy_Contracts, Transaction rejected: "
+            << responses[i].dump();
+        accounts_->invalidate(senders[i]);
+      }
+    }
+
+    std::map<std::string, nlohmann::json> receipts;
+    await_receipts(transaction_IDs, &receipts);
+    accounts_->release(senders);
+
+    for (const auto &transaction_ID : transaction_IDs) {
+      auto receipt = receipts.find(transaction_ID);
+      if (receipt != receipts.end() &&
+          receipt->second.contains("contractAddress") &&
+          receipt->second["contractAddress"].is_string()) {
+        addresses.push_back(receipt->second["contractAddress"]);
+      }
+    }
+    next += senders.size();
   }
-  BOOST_LOG_TRIVIAL(debug)
-      << "Ethereum Adapter: check_transaction_receipt, Response: " << response;
-  return false;
+
+  return addresses.size() - deployed_before == count ? 0 : 1;
 }
 
 auto EthereumAdapter::createRpcBatch(std::map<RpcParams, bool> batch,
                                      std::map<RpcParams, std::string> key_map)
     -> std::pair<std::map<std::string, std::string>,
                  std::map<std::string, std::string>> {
-  std::string from_address = accountAddress_;
   std::map<RpcParams, bool>::iterator batch_iter;
   std::map<std::string, std::string> batch_transform;
   std::map<std::string, std::string> key_map_transform;
@@ -760,19 +1262,23 @@ auto EthereumAdapter::createRpcBatch(std::map<RpcParams, bool> batch,
     // create intermediate structure for the params
     RpcParams intermed = batch_iter->first;
 
-    intermed.from = from_address;
+    if (intermed.from.empty()) {
+      intermed.from = accountAddress_;
+    }
 
     if (intermed.to.empty()) {
       intermed.to = storedContractAddress_;
     }
-    if (batch_iter->second) {
+    if (batch_iter->second && intermed.gas.empty()) {
       intermed.gas = kEthereumGas;
     }
 
-    // do we need to change the way how the nonce is updated? what is the real
-    // logic behind that?
-    if (intermed.method == "eth_sendTransaction") {
-      intermed.nonce = ++nonce_;
+    // without a nonce the node assigns the next one of the account
+    uint64_t nonce = 0;
+    if (intermed.method == "eth_sendTransaction" &&
+        allocate_nonce(intermed.from, nonce)) {
+      intermed.nonce = nonce;
+      intermed.has_nonce = true;
     }
 
     std::string json = parse_params_to_json(intermed);
@@ -804,49 +1310,57 @@ auto EthereumAdapter::sendRpcBatch(std::map<std::string, std::string> batch,
   std::map<std::string, std::string>::iterator json_tid_iter;
   std::vector<std::string> output;
 
-  std::string read_buffer;
+  // initiate all transactions of the batch on the blockchain with one request
+  // without waiting for them to be mined
+  std::vector<std::pair<std::string, std::string>> requests;
+  requests.reserve(batch.size());
+  for (batch_iter = batch.begin(); batch_iter != batch.end(); ++batch_iter) {
+    requests.emplace_back(batch_iter->second, batch_iter->first);
+  }
+  const std::vector<nlohmann::json> responses = call_batch(requests);
 
-  // iterate over all elements in the batch and initiate the transactions on the
-  // blockchain
+  size_t request_id = 0;
+  std::set<std::string> rejected_senders;
   for (batch_iter = batch.begin(); batch_iter != batch.end(); ++batch_iter) {
-    std::string read_buffer_call;
-    const std::string post_data = R"({"jsonrpc":"2.0","id":1,"method":")" +
-                                  batch_iter->second + R"(","params":[)" +
-                                  batch_iter->first + "]}";
-
-    if (curl_ != nullptr) {
-      struct curl_slist *headers = nullptr;
-      headers = curl_slist_append(headers, "Content-Type: application/json");
-
-      curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
-      curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &read_buffer_call);
-      curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, post_data.c_str());
-      CURLcode res = curl_easy_perform(curl_);
-
-      if (res != CURLE_OK) {
-        auto msg = "CURL perform() returned an error: " +
-                   std::string(curl_easy_strerror(res));
-        BOOST_LOG_TRIVIAL(debug) << "Ethereum Adapter: Call, " << msg;
+    const nlohmann::json &response = responses[request_id++];
+    std::string transaction_id;
+    if (response.contains("result") && response["result"].is_string()) {
+      transaction_id = response["result"].get<std::string>();
+    } else {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: sendRpcBatch, Transaction rejected: "
+          << response.dump();
+      try {
+        rejected_senders.insert(
+            nlohmann::json::parse(batch_iter->first).value("from", ""));
+      } catch (nlohmann::detail::exception &) {
       }
     }
-    nlohmann::json json_response;
-    parseTX_response(read_buffer_call, json_response);
-    auto transaction_id = json_response["result"].get<std::string>();
 
     // create mapping between json and the transaction id
     json_tid_map.insert(
         std::pair<std::string, std::string>(batch_iter->first, transaction_id));
   }
 
-  // check for all transactionIDs if the transaction has finished or not
+  // rejected transactions leave gaps in the nonces of their accounts or were
+  // rejected because the nonces are out of sync with the chain
+  for (const auto &sender : rejected_senders) {
+    accounts_->invalidate(sender);
+  }
+
+  // confirm all transactions together
+  std::vector<std::string> transaction_ids;
+  transaction_ids.reserve(json_tid_map.size());
   for (json_tid_iter = json_tid_map.begin();
        json_tid_iter != json_tid_map.end(); ++json_tid_iter) {
-    read_buffer = check_mining_result(json_tid_iter->second);
-
-    // if error, then add the corresponding key to the return vector
-    if (!check_transaction_receipt(json_tid_iter->second)) {
-      read_buffer = "error";
+    transaction_ids.push_back(json_tid_iter->second);
+  }
+  const std::set<std::string> failed = await_receipts(transaction_ids);
 
+  // if error, then add the corresponding key to the return vector
+  for (json_tid_iter = json_tid_map.begin();
+       json_tid_iter != json_tid_map.end(); ++json_tid_iter) {
+    if (failed.count(json_tid_iter->second) != 0) {
       key_map_iter = key_map.find(json_tid_iter->first);
       output.push_back(key_map_iter->second);
     }
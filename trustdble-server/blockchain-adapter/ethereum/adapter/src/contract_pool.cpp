@@ -0,0 +1,70 @@
+/*! \addtogroup group18
+ *  @{
+ */
+#include "adapter_ethereum/contract_pool.h"
+
+#include <boost/log/trivial.hpp>
+#include <chrono>
+#include <map>
+
+auto ContractPool::for_contract(const std::string &key, size_t size,
+                                const std::function<DEPLOY_FUNCTION()> &deploy)
+    -> std::shared_ptr<ContractPool> {
+  static std::mutex pools_mutex;
+  static std::map<std::string, std::shared_ptr<ContractPool>> pools;
+
+  std::lock_guard<std::mutex> lock(pools_mutex);
+  auto &pool = pools[key];
+  if (pool == nullptr) {
+    pool = std::make_shared<ContractPool>(size, deploy());
+  }
+  return pool;
+}
+
+ContractPool::ContractPool(size_t size, DEPLOY_FUNCTION deploy)
+    : size_(size), deploy_(std::move(deploy)) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  start_refill();
+}
+
+ContractPool::~ContractPool() {
+  if (refill_.valid()) {
+    refill_.wait();
+  }
+}
+
+auto ContractPool::claim(std::string &address) -> bool {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool claimed = false;
+  if (!contracts_.empty()) {
+    address = contracts_.front();
+    contracts_.pop_front();
+    claimed = true;
+  }
+  start_refill();
+  return claimed;
+}
+
+void ContractPool::start_refill() {
+  if (refill_.valid() && refill_.wait_for(std::chrono::seconds(0)) !=
+                             std::future_status::ready) {
+    return;
+  }
+  const size_t missing =
+      contracts_.size() < size_ ? size_ - contracts_.size() : 0;
+  if (missing == 0) {
+    return;
+  }
+
+  refill_ = std::async(std::launch::async, [this, missing] {
+    std::vector<std::string> deployed;
+    if (deploy_(missing, deployed) != 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Contract_Pool, Refill failed, deployed "
+          << deployed.size() << " of " << missing << " contracts";
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    contracts_.insert(contracts_.end(), deployed.begin(), deployed.end());
+  });
+}
+/** @} */
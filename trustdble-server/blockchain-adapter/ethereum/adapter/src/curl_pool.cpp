@@ -0,0 +1,94 @@
+/*! \addtogroup group15
+ *  @{
+ */
+#include "adapter_ethereum/curl_pool.h"
+
+#include <map>
+
+auto CurlPool::for_endpoint(const std::string &url)
+    -> std::shared_ptr<CurlPool> {
+  static std::once_flag curl_initialized;
+  static std::mutex pools_mutex;
+  // pools live as long as the process, so connections survive the short-lived
+  // adapters of single statements
+  static std::map<std::string, std::shared_ptr<CurlPool>> pools;
+
+  // curl_easy_init() would initialize curl implicitly, which isn't thread-safe
+  std::call_once(curl_initialized,
+                 [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+  std::lock_guard<std::mutex> lock(pools_mutex);
+  auto &pool = pools[url];
+  if (pool == nullptr) {
+    pool = std::make_shared<CurlPool>(url);
+  }
+  return pool;
+}
+
+CurlPool::CurlPool(std::string url)
+    : url_(std::move(url)),
+      headers_(curl_slist_append(nullptr, "Content-Type: application/json")) {}
+
+CurlPool::~CurlPool() {
+  for (CURL *curl : idle_) {
+    curl_easy_cleanup(curl);
+  }
+  curl_slist_free_all(headers_);
+}
+
+auto CurlPool::post(const std::string &post_data, std::string &response)
+    -> CURLcode {
+  CURL *curl = acquire();
+  if (curl == nullptr) {
+    return CURLE_FAILED_INIT;
+  }
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_data.c_str());
+  CURLcode res = curl_easy_perform(curl);
+  release(curl);
+  return res;
+}
+
+auto CurlPool::acquire() -> CURL * {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      CURL *curl = idle_.back();
+      idle_.pop_back();
+      return curl;
+    }
+  }
+
+  CURL *curl = curl_easy_init();
+  if (curl != nullptr) {
+    curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    // requests are small, don't wait for the ACK of the previous segment
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    // curl must not use signals in a multi-threaded server
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  }
+  return curl;
+}
+
+void CurlPool::release(CURL *curl) {
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < MAX_IDLE_CONNECTIONS) {
+      idle_.push_back(curl);
+      return;
+    }
+  }
+  curl_easy_cleanup(curl);
+}
+
+auto CurlPool::write_callback(char *contents, size_t size, size_t nmemb,
+                              void *userp) -> size_t {
+  ((std::string *)userp)->append(contents, size * nmemb);
+  return size * nmemb;
+}
+/** @} */
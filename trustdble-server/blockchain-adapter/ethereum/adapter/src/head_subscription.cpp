@@ -0,0 +1,193 @@
+/*! \addtogroup group19
+ *  @{
+ */
+#include "adapter_ethereum/head_subscription.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <chrono>
+#include <cstring>
+#include <map>
+
+#include "adapter_ethereum/json.hpp"
+
+constexpr static auto kSubscribeNewHeads =
+    R"({"jsonrpc":"2.0","id":1,"method":"eth_subscribe","params":["newHeads"]})";
+
+auto HeadSubscription::for_endpoint(const std::string &ipc_path)
+    -> std::shared_ptr<HeadSubscription> {
+  static std::mutex subscriptions_mutex;
+  static std::map<std::string, std::shared_ptr<HeadSubscription>>
+      subscriptions;
+
+  std::lock_guard<std::mutex> lock(subscriptions_mutex);
+  auto &subscription = subscriptions[ipc_path];
+  if (subscription == nullptr) {
+    subscription = std::make_shared<HeadSubscription>(ipc_path);
+  }
+  return subscription;
+}
+
+HeadSubscription::HeadSubscription(std::string ipc_path)
+    : ipc_path_(std::move(ipc_path)), reader_([this] { run(); }) {}
+
+HeadSubscription::~HeadSubscription() {
+  stop_ = true;
+  if (reader_.joinable()) {
+    reader_.join();
+  }
+}
+
+auto HeadSubscription::connected() -> bool {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connected_;
+}
+
+auto HeadSubscription::head() -> uint64_t {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return head_;
+}
+
+auto HeadSubscription::wait_for_head(uint64_t seen, size_t timeout)
+    -> uint64_t {
+  std::unique_lock<std::mutex> lock(mutex_);
+  new_head_.wait_for(lock, std::chrono::milliseconds(timeout),
+                     [&] { return head_ > seen || !connected_; });
+  return head_;
+}
+
+void HeadSubscription::run() {
+  while (!stop_) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, ipc_path_.c_str(), sizeof(address.sun_path) - 1);
+
+    if (fd >= 0 &&
+        connect(fd, reinterpret_cast<struct sockaddr *>(&address),
+                sizeof(address)) == 0 &&
+        send(fd, kSubscribeNewHeads, strlen(kSubscribeNewHeads),
+             MSG_NOSIGNAL) > 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Head_Subscription, Subscribed to newHeads at "
+          << ipc_path_;
+      read_notifications(fd);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      connected_ = false;
+    }
+    // waiting callers fall back to polling
+    new_head_.notify_all();
+
+    for (size_t waited = 0; !stop_ && waited < IPC_RECONNECT_INTERVAL;
+         waited += IPC_READ_TIMEOUT) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(IPC_READ_TIMEOUT));
+    }
+  }
+}
+
+void HeadSubscription::read_notifications(int fd) {
+  std::string buffer;
+  // the node writes a stream of JSON objects, they are split by their braces
+  size_t message_begin = 0;
+  size_t scanned = 0;
+  int depth = 0;
+  bool in_string = false;
+  bool escaped = false;
+
+  char chunk[4096];
+  struct pollfd poll_fd {
+    fd, POLLIN, 0
+  };
+  while (!stop_) {
+    int ready = poll(&poll_fd, 1, IPC_READ_TIMEOUT);
+    if (ready < 0) {
+      return;
+    }
+    if (ready == 0) {
+      continue;
+    }
+    ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "Ethereum Adapter: Head_Subscription, Connection closed";
+      return;
+    }
+    buffer.append(chunk, received);
+
+    for (; scanned < buffer.size(); scanned++) {
+      const char c = buffer[scanned];
+      if (in_string) {
+        if (escaped) {
+          escaped = false;
+        } else if (c == '\\') {
+          escaped = true;
+        } else if (c == '"') {
+          in_string = false;
+        }
+      } else if (c == '"') {
+        in_string = true;
+      } else if (c == '{') {
+        if (depth++ == 0) {
+          message_begin = scanned;
+        }
+      } else if (c == '}' && depth > 0 && --depth == 0) {
+        handle_message(
+            buffer.substr(message_begin, scanned + 1 - message_begin));
+      }
+    }
+    // keep only the incomplete message
+    if (depth == 0) {
+      buffer.clear();
+      scanned = 0;
+    } else if (message_begin > 0) {
+      buffer.erase(0, message_begin);
+      scanned -= message_begin;
+      message_begin = 0;
+    }
+  }
+}
+
+void HeadSubscription::handle_message(const std::string &message) {
+  try {
+    auto json = nlohmann::json::parse(message);
+    if (json.contains("id")) {
+      // response to eth_subscribe
+      const bool subscribed = json.contains("result");
+      if (!subscribed) {
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Head_Subscription, Subscribe failed: "
+            << message;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      connected_ = subscribed;
+      return;
+    }
+    auto hex_number = json.at("params")
+                          .at("result")
+                          .at("number")
+                          .get<std::string>()
+                          .substr(2);  // 0x
+    const uint64_t number = strtoull(hex_number.c_str(), nullptr, 16);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      head_ = std::max(head_, number);
+    }
+    new_head_.notify_all();
+  } catch (std::exception &e) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "Ethereum Adapter: Head_Subscription, Can not parse notification "
+        << message << " Error: " << e.what();
+  }
+}
+/** @} */
@@ -0,0 +1,40 @@
+/*! \addtogroup group13
+ *  @{
+ */
+#include "adapter_ethereum/nonce_manager.h"
+
+#include <map>
+
+auto NonceManager::for_account(const std::string &url,
+                               const std::string &account)
+    -> std::shared_ptr<NonceManager> {
+  static std::mutex managers_mutex;
+  static std::map<std::string, std::shared_ptr<NonceManager>> managers;
+
+  std::lock_guard<std::mutex> lock(managers_mutex);
+  auto &manager = managers[url + "|" + account];
+  if (manager == nullptr) {
+    manager = std::make_shared<NonceManager>();
+  }
+  return manager;
+}
+
+auto NonceManager::allocate(const SEED_FUNCTION &seed, uint64_t &nonce)
+    -> bool {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!seeded_) {
+    // the transaction count of an account is the nonce of its next transaction
+    if (!seed(next_)) {
+      return false;
+    }
+    seeded_ = true;
+  }
+  nonce = next_++;
+  return true;
+}
+
+void NonceManager::invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  seeded_ = false;
+}
+/** @} */
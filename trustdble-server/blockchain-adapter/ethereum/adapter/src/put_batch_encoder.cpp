@@ -0,0 +1,110 @@
+/*! \addtogroup group110
+ *  @{
+ */
+#include "adapter_ethereum/put_batch_encoder.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+
+#include "adapter_utils/encoding_helpers.h"
+
+//! The hash of the putBatch method signature of trustdble ethereum contract
+constexpr static auto kEthereumMethodHashPutBatch = "0x410f08ab";
+//! The hash of the putBatch(bytes32[],bytes[]) method signature of version 2
+constexpr static auto kEthereumMethodHashPutBatchV2 = "0x402081c0";
+
+auto PutBatchEncoder::plan(
+    const std::vector<std::pair<std::string, std::string>> &rows,
+    uint64_t block_gas_limit, uint64_t contract_version,
+    const GasEstimator &estimate) -> std::vector<PutBatchChunk> {
+  const uint64_t gas_budget = block_gas_limit * MAX_BLOCK_GAS_SHARE / 100;
+  std::vector<PutBatchChunk> planned;
+  std::vector<PutBatchChunk> candidates = {{0, rows.size(), 0}};
+
+  while (!candidates.empty()) {
+    std::vector<std::string> data;
+    data.reserve(candidates.size());
+    for (const auto &candidate : candidates) {
+      data.push_back(
+          encode(rows, candidate.begin, candidate.end, contract_version));
+    }
+    std::vector<uint64_t> estimations = estimate(data);
+    estimations.resize(candidates.size(), 0);
+
+    std::vector<PutBatchChunk> oversized;
+    for (size_t i = 0; i < candidates.size(); i++) {
+      PutBatchChunk candidate = candidates[i];
+      const size_t num_rows = candidate.end - candidate.begin;
+      const uint64_t gas = estimations[i];
+
+      if (gas > 0 && gas <= gas_budget) {
+        candidate.gas = std::min(block_gas_limit,
+                                 gas * (100 + GAS_ESTIMATE_MARGIN) / 100);
+        planned.push_back(candidate);
+        continue;
+      }
+      if (num_rows == 1) {
+        // can't be split, the transaction decides whether the row fits
+        BOOST_LOG_TRIVIAL(debug)
+            << "Ethereum Adapter: Plan_Put_Batches, Row exceeds gas budget: "
+            << gas;
+        candidate.gas = gas_budget;
+        planned.push_back(candidate);
+        continue;
+      }
+
+      // split into parts that fit the budget according to the gas per row,
+      // without an estimation (e.g. gas exceeds the block limit) halve it
+      size_t rows_per_part = num_rows / 2;
+      if (gas > 0) {
+        rows_per_part = std::max<size_t>(
+            1, std::min<size_t>(num_rows - 1, num_rows * gas_budget / gas));
+      }
+      for (size_t begin = candidate.begin; begin < candidate.end;
+           begin += rows_per_part) {
+        oversized.push_back(
+            {begin, std::min(candidate.end, begin + rows_per_part), 0});
+      }
+    }
+    candidates.swap(oversized);
+  }
+
+  // send the chunks in the order of the rows
+  std::sort(planned.begin(), planned.end(),
+            [](const PutBatchChunk &a, const PutBatchChunk &b) {
+              return a.begin < b.begin;
+            });
+  return planned;
+}
+
+auto PutBatchEncoder::encode(
+    const std::vector<std::pair<std::string, std::string>> &rows,
+    size_t begin, size_t end, uint64_t contract_version) -> std::string {
+  // string[] and bytes[] are encoded alike, only the method differs
+  const char *method = contract_version >= 2 ? kEthereumMethodHashPutBatchV2
+                                             : kEthereumMethodHashPutBatch;
+  const size_t num_rows = end - begin;
+  std::string keys = int_to_hex(num_rows);
+  std::string offsets;
+  std::string values;
+  for (size_t i = begin; i < end; i++) {
+    // keys are bytes32, cut or padded with zeros
+    const std::string &key = rows[i].first;
+    keys.append(key, 0, VALUE_SIZE);
+    keys.append(VALUE_SIZE - std::min<size_t>(key.length(), VALUE_SIZE), '0');
+
+    // offset of a string relative to the start of the offsets
+    offsets.append(int_to_hex(num_rows * 32 + values.length() / 2));
+    const std::string &value = rows[i].second;
+    values.append(int_to_hex(value.length() / 2));
+    values.append(value);
+    values.append((VALUE_SIZE - value.length() % VALUE_SIZE) % VALUE_SIZE,
+                  '0');
+  }
+
+  // head with the offsets of both arrays, followed by the arrays
+  return method + int_to_hex(2 * 32) +
+         int_to_hex(2 * 32 + keys.length() / 2) + keys +
+         int_to_hex(num_rows) + offsets + values;
+}
+/** @} */
@@ -0,0 +1,225 @@
+/*! \addtogroup group14
+ *  @{
+ */
+#include "adapter_ethereum/rpc_decoder.h"
+
+// number of hex chars of an ABI word
+#define WORD_LENGTH 64
+// number of hex chars of the low 64 bit of an ABI word
+#define UINT64_LENGTH 16
+
+constexpr std::string_view RpcDecoder::VALUE_SEPARATOR;
+
+static auto nibble(char c) -> int {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+static auto skip_whitespace(std::string_view text, size_t pos) -> size_t {
+  while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' ||
+                               text[pos] == '\r' || text[pos] == '\t')) {
+    pos++;
+  }
+  return pos;
+}
+
+auto RpcDecoder::find_result(std::string_view response,
+                             std::string_view &result) -> bool {
+  size_t pos = response.find("\"result\"");
+  if (pos == std::string_view::npos) {
+    return false;
+  }
+  pos = skip_whitespace(response, pos + 8);
+  if (pos >= response.size() || response[pos] != ':') {
+    return false;
+  }
+  pos = skip_whitespace(response, pos + 1);
+  if (pos < response.size() && response[pos] == '[') {
+    pos = skip_whitespace(response, pos + 1);
+  }
+  if (pos >= response.size() || response[pos] != '"') {
+    // null, object or empty array
+    return false;
+  }
+  // hex strings and addresses don't contain escaped characters
+  size_t end = response.find('"', ++pos);
+  if (end == std::string_view::npos) {
+    return false;
+  }
+  if (end - pos >= 2 && response[pos] == '0' && response[pos + 1] == 'x') {
+    pos += 2;
+  }
+  result = response.substr(pos, end - pos);
+  return true;
+}
+
+auto RpcDecoder::is_revert(std::string_view response) -> bool {
+  size_t pos = response.find("\"error\"");
+  if (pos == std::string_view::npos) {
+    return false;
+  }
+  pos = response.find("\"message\"", pos);
+  if (pos == std::string_view::npos) {
+    return false;
+  }
+  pos = skip_whitespace(response, pos + 9);
+  if (pos >= response.size() || response[pos] != ':') {
+    return false;
+  }
+  pos = skip_whitespace(response, pos + 1);
+  if (pos >= response.size() || response[pos] != '"') {
+    return false;
+  }
+  // e.g. "execution reverted" or "VM Exception while processing transaction:
+  // revert"
+  size_t end = response.find('"', ++pos);
+  if (end == std::string_view::npos) {
+    return false;
+  }
+  return response.substr(pos, end - pos).find("revert") !=
+         std::string_view::npos;
+}
+
+auto RpcDecoder::decode_uint(std::string_view abi, size_t offset,
+                             uint64_t &value) -> bool {
+  size_t pos = offset * 2;
+  if (pos > abi.size() || abi.size() - pos < WORD_LENGTH) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < WORD_LENGTH; i++) {
+    int digit = nibble(abi[pos + i]);
+    // larger values can't be offsets or lengths of a response
+    if (digit < 0 || (i < WORD_LENGTH - UINT64_LENGTH && digit != 0)) {
+      return false;
+    }
+    value = (value << 4) | static_cast<uint64_t>(digit);
+  }
+  return true;
+}
+
+auto RpcDecoder::decode_bytes(std::string_view abi, size_t offset,
+                              BYTES &value) -> bool {
+  uint64_t length = 0;
+  if (!decode_uint(abi, offset, length)) {
+    return false;
+  }
+  size_t pos = (offset + 32) * 2;
+  if (pos > abi.size() || (abi.size() - pos) / 2 < length) {
+    return false;
+  }
+  BYTES decoded(length);
+  if (!decode_hex(abi.substr(pos, length * 2), decoded.value)) {
+    return false;
+  }
+  value = std::move(decoded);
+  return true;
+}
+
+auto RpcDecoder::decode_string(std::string_view abi, BYTES &value) -> int {
+  uint64_t offset = 0;
+  if (!decode_uint(abi, 0, offset) || !decode_bytes(abi, offset, value)) {
+    return 1;
+  }
+  return 0;
+}
+
+auto RpcDecoder::decode_batch(std::string_view abi,
+                              std::map<const BYTES, BYTES> &results) -> int {
+  uint64_t keys_offset = 0;
+  uint64_t values_offset = 0;
+  uint64_t num_keys = 0;
+  uint64_t values_length = 0;
+  if (!decode_uint(abi, 0, keys_offset) || !decode_uint(abi, 32, values_offset) ||
+      !decode_uint(abi, keys_offset, num_keys) ||
+      !decode_uint(abi, values_offset, values_length)) {
+    return -1;
+  }
+  size_t keys_pos = (keys_offset + 32) * 2;
+  size_t values_pos = (values_offset + 32) * 2;
+  if (keys_pos > abi.size() || (abi.size() - keys_pos) / WORD_LENGTH < num_keys ||
+      values_pos > abi.size() ||
+      (abi.size() - values_pos) / 2 < values_length) {
+    return -1;
+  }
+  std::string_view values = abi.substr(values_pos, values_length * 2);
+
+  size_t value_begin = 0;
+  for (uint64_t i = 0; i < num_keys; i++) {
+    // the separator must start at a byte boundary
+    size_t value_end = values.find(VALUE_SEPARATOR, value_begin);
+    while (value_end != std::string_view::npos && value_end % 2 != 0) {
+      value_end = values.find(VALUE_SEPARATOR, value_end + 1);
+    }
+    if (value_end == std::string_view::npos) {
+      return -1;
+    }
+
+    BYTES key(WORD_LENGTH / 2);
+    BYTES value((value_end - value_begin) / 2);
+    if (!decode_hex(abi.substr(keys_pos + i * WORD_LENGTH, WORD_LENGTH),
+                    key.value) ||
+        !decode_hex(values.substr(value_begin, value_end - value_begin),
+                    value.value)) {
+      return -1;
+    }
+    results.emplace(std::move(key), std::move(value));
+    value_begin = value_end + VALUE_SEPARATOR.size();
+  }
+  return static_cast<int>(num_keys);
+}
+
+auto RpcDecoder::decode_bytes_batch(std::string_view abi,
+                                    std::map<const BYTES, BYTES> &results)
+    -> int {
+  uint64_t keys_offset = 0;
+  uint64_t values_offset = 0;
+  uint64_t num_keys = 0;
+  uint64_t num_values = 0;
+  if (!decode_uint(abi, 0, keys_offset) || !decode_uint(abi, 32, values_offset) ||
+      !decode_uint(abi, keys_offset, num_keys) ||
+      !decode_uint(abi, values_offset, num_values) || num_keys != num_values) {
+    return -1;
+  }
+  size_t keys_pos = (keys_offset + 32) * 2;
+  if (keys_pos > abi.size() || (abi.size() - keys_pos) / WORD_LENGTH < num_keys) {
+    return -1;
+  }
+  // the offsets of the values are relative to the start of the offset list
+  size_t values_head = values_offset + 32;
+
+  for (uint64_t i = 0; i < num_keys; i++) {
+    uint64_t value_offset = 0;
+    BYTES key(WORD_LENGTH / 2);
+    BYTES value;
+    if (!decode_uint(abi, values_head + i * 32, value_offset) ||
+        !decode_bytes(abi, values_head + value_offset, value) ||
+        !decode_hex(abi.substr(keys_pos + i * WORD_LENGTH, WORD_LENGTH),
+                    key.value)) {
+      return -1;
+    }
+    results.emplace(std::move(key), std::move(value));
+  }
+  return static_cast<int>(num_keys);
+}
+
+auto RpcDecoder::decode_hex(std::string_view hex, unsigned char *out) -> bool {
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    int high = nibble(hex[i]);
+    int low = nibble(hex[i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    out[i / 2] = static_cast<unsigned char>((high << 4) | low);
+  }
+  return true;
+}
+/** @} */
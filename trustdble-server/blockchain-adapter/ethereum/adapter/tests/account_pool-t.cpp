@@ -0,0 +1,191 @@
+/** @defgroup group112 account_pool_test
+ *  @ingroup group1
+ *  @{
+ */
+
+/**
+ * @file
+ * @brief This file contains tests for the pool of sender accounts and the
+ * allocation of their nonces, which don't require an Ethereum node.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+
+#include "adapter_ethereum/account_pool.h"
+#include "adapter_ethereum/nonce_manager.h"
+
+//! Seed function returning a fixed transaction count, counting its calls
+static auto seed_with(uint64_t count, int &calls)
+    -> NonceManager::SEED_FUNCTION {
+  return [count, &calls](uint64_t &next) {
+    calls++;
+    next = count;
+    return true;
+  };
+}
+
+TEST(NonceManagerTests, allocateConsecutiveNonces) {
+  NonceManager nonces;
+  int calls = 0;
+  uint64_t nonce = 0;
+  for (uint64_t expected = 5; expected < 10; expected++) {
+    ASSERT_TRUE(nonces.allocate(seed_with(5, calls), nonce));
+    EXPECT_EQ(nonce, expected);
+  }
+  // seeded only once
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(NonceManagerTests, failedSeed) {
+  NonceManager nonces;
+  uint64_t nonce = 0;
+  EXPECT_FALSE(nonces.allocate([](uint64_t &) { return false; }, nonce));
+
+  // the next allocation tries to seed again
+  int calls = 0;
+  ASSERT_TRUE(nonces.allocate(seed_with(3, calls), nonce));
+  EXPECT_EQ(nonce, 3U);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(NonceManagerTests, invalidateResyncs) {
+  NonceManager nonces;
+  int calls = 0;
+  uint64_t nonce = 0;
+  ASSERT_TRUE(nonces.allocate(seed_with(0, calls), nonce));
+  ASSERT_TRUE(nonces.allocate(seed_with(0, calls), nonce));
+  EXPECT_EQ(nonce, 1U);
+
+  // a rejected transaction left a gap, the chain counts one transaction
+  nonces.invalidate();
+  ASSERT_TRUE(nonces.allocate(seed_with(1, calls), nonce));
+  EXPECT_EQ(nonce, 1U);
+  ASSERT_TRUE(nonces.allocate(seed_with(1, calls), nonce));
+  EXPECT_EQ(nonce, 2U);
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(NonceManagerTests, concurrentAllocations) {
+  auto nonces = NonceManager::for_account("nonce-test-concurrent", "0xaa");
+  std::atomic<int> calls{0};
+  auto seed = [&calls](uint64_t &next) {
+    calls++;
+    next = 100;
+    return true;
+  };
+
+  std::vector<std::future<std::vector<uint64_t>>> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::async(std::launch::async, [&] {
+      // adapters of the same account share the allocator
+      auto shared = NonceManager::for_account("nonce-test-concurrent", "0xaa");
+      std::vector<uint64_t> allocated;
+      for (int i = 0; i < 100; i++) {
+        uint64_t nonce = 0;
+        EXPECT_TRUE(shared->allocate(seed, nonce));
+        allocated.push_back(nonce);
+      }
+      return allocated;
+    }));
+  }
+  std::set<uint64_t> all;
+  for (auto &thread : threads) {
+    for (uint64_t nonce : thread.get()) {
+      EXPECT_TRUE(all.insert(nonce).second);
+    }
+  }
+  EXPECT_EQ(all.size(), 400U);
+  EXPECT_EQ(*all.begin(), 100U);
+  EXPECT_EQ(*all.rbegin(), 499U);
+  EXPECT_EQ(calls, 1);
+
+  // other accounts and endpoints have their own allocator
+  EXPECT_NE(NonceManager::for_account("nonce-test-concurrent", "0xbb"),
+            nonces);
+  EXPECT_NE(NonceManager::for_account("nonce-test-other", "0xaa"), nonces);
+}
+
+TEST(AccountPoolTests, acquireRespectsLimits) {
+  AccountPool pool("pool-test-limits", {"0xa", "0xb", "0xa"}, 2);
+  EXPECT_EQ(pool.size(), 2U);
+  EXPECT_TRUE(pool.acquire(0).empty());
+
+  // all free slots of both accounts, spread over the accounts
+  std::vector<std::string> senders = pool.acquire(10);
+  ASSERT_EQ(senders.size(), 4U);
+  EXPECT_EQ(std::count(senders.begin(), senders.end(), "0xa"), 2);
+  EXPECT_EQ(std::count(senders.begin(), senders.end(), "0xb"), 2);
+  EXPECT_EQ(senders[0], "0xa");
+  EXPECT_EQ(senders[1], "0xb");
+
+  // releasing unknown accounts or more than acquired is ignored
+  pool.release({"0xc"});
+  pool.release({"0xb", "0xb", "0xb"});
+  senders = pool.acquire(10);
+  ASSERT_EQ(senders.size(), 2U);
+  EXPECT_EQ(senders[0], "0xb");
+  EXPECT_EQ(senders[1], "0xb");
+}
+
+TEST(AccountPoolTests, acquireLeastLoaded) {
+  AccountPool pool("pool-test-least-loaded", {"0xa", "0xb", "0xc"}, 4);
+  std::vector<std::string> senders = pool.acquire(6);
+  ASSERT_EQ(senders.size(), 6U);
+
+  // 0xb has the fewest transactions in flight after its release
+  pool.release({"0xb", "0xb", "0xc"});
+  senders = pool.acquire(1);
+  ASSERT_EQ(senders.size(), 1U);
+  EXPECT_EQ(senders[0], "0xb");
+  senders = pool.acquire(2);
+  ASSERT_EQ(senders.size(), 2U);
+  EXPECT_NE(senders[0], "0xa");
+  EXPECT_NE(senders[1], "0xa");
+}
+
+TEST(AccountPoolTests, acquireBlocksUntilRelease) {
+  AccountPool pool("pool-test-blocking", {"0xa"}, 1);
+  ASSERT_EQ(pool.acquire(1).size(), 1U);
+
+  auto blocked = std::async(std::launch::async, [&pool] {
+    return pool.acquire(3);
+  });
+  EXPECT_EQ(blocked.wait_for(std::chrono::milliseconds(100)),
+            std::future_status::timeout);
+
+  pool.release({"0xa"});
+  ASSERT_EQ(blocked.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_EQ(blocked.get(), std::vector<std::string>({"0xa"}));
+}
+
+TEST(AccountPoolTests, sharedPoolsAndNonces) {
+  auto pool = AccountPool::for_accounts("pool-test-shared", {"0xa", "0xb"}, 2);
+  EXPECT_EQ(AccountPool::for_accounts("pool-test-shared", {"0xa", "0xb"}, 2),
+            pool);
+  EXPECT_NE(AccountPool::for_accounts("pool-test-shared", {"0xa"}, 2), pool);
+
+  // nonces are shared with adapters sending from the account outside of the
+  // pool
+  int calls = 0;
+  uint64_t nonce = 0;
+  ASSERT_TRUE(pool->allocate_nonce("0xa", seed_with(7, calls), nonce));
+  EXPECT_EQ(nonce, 7U);
+  ASSERT_TRUE(NonceManager::for_account("pool-test-shared", "0xa")
+                  ->allocate(seed_with(0, calls), nonce));
+  EXPECT_EQ(nonce, 8U);
+  EXPECT_FALSE(pool->allocate_nonce("0xc", seed_with(0, calls), nonce));
+
+  pool->invalidate("0xa");
+  ASSERT_TRUE(pool->allocate_nonce("0xa", seed_with(20, calls), nonce));
+  EXPECT_EQ(nonce, 20U);
+  EXPECT_EQ(calls, 2);
+}
+/** @} */
@@ -0,0 +1,179 @@
+/** @defgroup group111 put_batch_encoder_test
+ *  @ingroup group1
+ *  @{
+ */
+
+/**
+ * @file
+ * @brief This file contains tests for the planning and encoding of putBatch
+ * transactions, which don't require an Ethereum node.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "adapter_ethereum/put_batch_encoder.h"
+#include "adapter_ethereum/rpc_decoder.h"
+#include "adapter_utils/encoding_helpers.h"
+
+//! Length of the method hash with 0x at the start of the transaction data
+#define METHOD_LENGTH 10
+
+//! Number of rows of an encoded transaction
+static auto encoded_rows(const std::string &data) -> uint64_t {
+  uint64_t rows = 0;
+  EXPECT_TRUE(RpcDecoder::decode_uint(data.substr(METHOD_LENGTH), 64, rows));
+  return rows;
+}
+
+//! Estimator with a fixed amount of gas per row, counting its calls
+static auto gas_per_row(uint64_t gas, int &calls)
+    -> PutBatchEncoder::GasEstimator {
+  return [gas, &calls](const std::vector<std::string> &data) {
+    calls++;
+    std::vector<uint64_t> estimations;
+    for (const auto &transaction : data) {
+      estimations.push_back(gas * encoded_rows(transaction));
+    }
+    return estimations;
+  };
+}
+
+//! Rows with keys and values of the given length in bytes
+static auto make_rows(size_t count, size_t value_length)
+    -> std::vector<std::pair<std::string, std::string>> {
+  std::vector<std::pair<std::string, std::string>> rows;
+  for (size_t i = 0; i < count; i++) {
+    rows.emplace_back(string_to_hex("key" + std::to_string(i)),
+                      string_to_hex(std::string(value_length, 'a' + i % 26)));
+  }
+  return rows;
+}
+
+TEST(PutBatchEncoderTests, encodeEmpty) {
+  std::vector<std::pair<std::string, std::string>> rows;
+  // offsets of both arrays and their lengths
+  EXPECT_EQ(PutBatchEncoder::encode(rows, 0, 0, 1),
+            "0x410f08ab" + int_to_hex(64) + int_to_hex(96) + int_to_hex(0) +
+                int_to_hex(0));
+}
+
+TEST(PutBatchEncoderTests, encodeSingleRow) {
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {string_to_hex("key"), string_to_hex("value")}};
+  std::string key = string_to_hex("key");
+  std::string value = string_to_hex("value");
+  EXPECT_EQ(PutBatchEncoder::encode(rows, 0, 1, 1),
+            "0x410f08ab" + int_to_hex(64) + int_to_hex(128) + int_to_hex(1) +
+                key + std::string(VALUE_SIZE - key.length(), '0') +
+                int_to_hex(1) + int_to_hex(32) + int_to_hex(5) + value +
+                std::string(VALUE_SIZE - value.length(), '0'));
+
+  // contracts of version 2 take bytes[] instead of string[]
+  EXPECT_EQ(PutBatchEncoder::encode(rows, 0, 1, 2).substr(0, METHOD_LENGTH),
+            "0x402081c0");
+}
+
+TEST(PutBatchEncoderTests, encodeSeveralRows) {
+  // values of 0, 31, 33 and 70 bytes aren't aligned to words, the key of the
+  // last row exceeds 32 bytes and is cut
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {string_to_hex("ignored"), string_to_hex("ignored")},
+      {string_to_hex("key1"), ""},
+      {string_to_hex("key2"), string_to_hex(std::string(31, 'b'))},
+      {string_to_hex("key3"), string_to_hex(std::string(33, 'c'))},
+      {string_to_hex(std::string(40, 'k')),
+       string_to_hex(std::string(70, 'd'))},
+      {string_to_hex("ignored"), string_to_hex("ignored")}};
+  const std::string data = PutBatchEncoder::encode(rows, 1, 5, 2);
+
+  std::string abi = data.substr(METHOD_LENGTH);
+  ASSERT_EQ(abi.length() % VALUE_SIZE, 0U);
+  uint64_t word = 0;
+  ASSERT_TRUE(RpcDecoder::decode_uint(abi, 0, word));
+  EXPECT_EQ(word, 64U);
+  ASSERT_TRUE(RpcDecoder::decode_uint(abi, 32, word));
+  EXPECT_EQ(word, 64U + 32 + 4 * 32);
+  EXPECT_EQ(encoded_rows(data), 4U);
+  EXPECT_EQ(abi.substr(3 * VALUE_SIZE, VALUE_SIZE),
+            string_to_hex("key1") + std::string(VALUE_SIZE - 8, '0'));
+  EXPECT_EQ(abi.substr(6 * VALUE_SIZE, VALUE_SIZE),
+            string_to_hex(std::string(32, 'k')));
+
+  // each value is found at its offset relative to the offsets of the array
+  const size_t values = 64 + 32 + 4 * 32;
+  ASSERT_TRUE(RpcDecoder::decode_uint(abi, values, word));
+  EXPECT_EQ(word, 4U);
+  for (size_t row = 1; row < 5; row++) {
+    uint64_t offset = 0;
+    ASSERT_TRUE(
+        RpcDecoder::decode_uint(abi, values + 32 + (row - 1) * 32, offset));
+    uint64_t length = 0;
+    ASSERT_TRUE(RpcDecoder::decode_uint(abi, values + 32 + offset, length));
+    EXPECT_EQ(length, rows[row].second.length() / 2);
+    EXPECT_EQ(abi.substr(2 * (values + 32 + offset + 32),
+                         rows[row].second.length()),
+              rows[row].second);
+  }
+
+  // the last value ends the transaction, padded to a word
+  EXPECT_EQ(abi.length(),
+            2 * (values + 32 + 4 * 32 + 4 * 32 + 0 + 32 + 64 + 96));
+}
+
+TEST(PutBatchEncoderTests, planSingleTransaction) {
+  auto rows = make_rows(20, 10);
+  int calls = 0;
+  auto chunks = PutBatchEncoder::plan(rows, 10000, 2, gas_per_row(100, calls));
+  ASSERT_EQ(chunks.size(), 1U);
+  EXPECT_EQ(chunks[0].begin, 0U);
+  EXPECT_EQ(chunks[0].end, 20U);
+  EXPECT_EQ(chunks[0].gas, 2000U * (100 + GAS_ESTIMATE_MARGIN) / 100);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(PutBatchEncoderTests, planSplitsOversizedTransaction) {
+  // 20 rows need 2000 gas, the budget of a transaction is 900
+  auto rows = make_rows(20, 50);
+  int calls = 0;
+  auto chunks = PutBatchEncoder::plan(rows, 1000, 2, gas_per_row(100, calls));
+  ASSERT_EQ(chunks.size(), 3U);
+  size_t begin = 0;
+  for (const auto &chunk : chunks) {
+    EXPECT_EQ(chunk.begin, begin);
+    EXPECT_LE(chunk.end - chunk.begin, 9U);
+    // the margin is capped by the block gas limit
+    EXPECT_EQ(chunk.gas,
+              std::min<uint64_t>(1000, (chunk.end - chunk.begin) * 100 *
+                                           (100 + GAS_ESTIMATE_MARGIN) / 100));
+    begin = chunk.end;
+  }
+  EXPECT_EQ(begin, 20U);
+  // the parts are estimated together
+  EXPECT_EQ(calls, 2);
+
+  // a single row that exceeds the budget is sent with the budget
+  calls = 0;
+  chunks = PutBatchEncoder::plan(make_rows(1, 10), 1000, 2,
+                                 gas_per_row(5000, calls));
+  ASSERT_EQ(chunks.size(), 1U);
+  EXPECT_EQ(chunks[0].gas, 900U);
+}
+
+TEST(PutBatchEncoderTests, planWithFailedEstimations) {
+  // without estimations the rows are halved until they can't be split
+  auto rows = make_rows(5, 10);
+  int calls = 0;
+  auto chunks = PutBatchEncoder::plan(
+      rows, 1000, 2, [&calls](const std::vector<std::string> &data) {
+        calls++;
+        return std::vector<uint64_t>(calls == 1 ? data.size() : 0, 0);
+      });
+  ASSERT_EQ(chunks.size(), 5U);
+  for (size_t i = 0; i < chunks.size(); i++) {
+    EXPECT_EQ(chunks[i].begin, i);
+    EXPECT_EQ(chunks[i].end, i + 1);
+    EXPECT_EQ(chunks[i].gas, 900U);
+  }
+  EXPECT_EQ(calls, 3);
+}
+/** @} */
@@ -0,0 +1,156 @@
+/** @defgroup group16 rpc_decoder_test
+ *  @ingroup group1
+ *  @{
+ */
+
+/**
+ * @file
+ * @brief This file contains tests for the decoder of Ethereum RPC responses,
+ * which don't require an Ethereum node.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "adapter_ethereum/rpc_decoder.h"
+#include "adapter_utils/encoding_helpers.h"
+
+//! ABI-encoded string as returned by the get method of the contract
+static auto encode_string(const std::string &value) -> std::string {
+  std::string hex = string_to_hex(value);
+  hex.append((VALUE_SIZE - hex.length() % VALUE_SIZE) % VALUE_SIZE, '0');
+  return int_to_hex(32) + int_to_hex(value.length()) + hex;
+}
+
+TEST(RpcDecoderTests, findResult) {
+  std::string_view result;
+  EXPECT_TRUE(RpcDecoder::find_result(
+      R"({"jsonrpc":"2.0","id":1,"result":"0x1a2b"})", result));
+  EXPECT_EQ(result, "1a2b");
+
+  // list of accounts with whitespace
+  EXPECT_TRUE(RpcDecoder::find_result(
+      R"({"jsonrpc": "2.0", "id": 1, "result": [ "0xaa", "0xbb"]})", result));
+  EXPECT_EQ(result, "aa");
+
+  EXPECT_FALSE(RpcDecoder::find_result(
+      R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,"message":"execution reverted"}})",
+      result));
+  EXPECT_FALSE(RpcDecoder::find_result(
+      R"({"jsonrpc":"2.0","id":1,"result":null})", result));
+  EXPECT_FALSE(RpcDecoder::find_result("", result));
+}
+
+TEST(RpcDecoderTests, isRevert) {
+  EXPECT_TRUE(RpcDecoder::is_revert(
+      R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,"message":"execution reverted"}})"));
+  EXPECT_TRUE(RpcDecoder::is_revert(
+      R"({"id": 1, "error": {"message": "VM Exception while processing transaction: revert", "code": -32000}})"));
+
+  // errors of the node don't tell anything about the contract
+  EXPECT_FALSE(RpcDecoder::is_revert(
+      R"({"jsonrpc":"2.0","id":1,"error":{"code":-32005,"message":"rate limit exceeded"}})"));
+  EXPECT_FALSE(RpcDecoder::is_revert(
+      R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,"message":"header not found"}})"));
+  EXPECT_FALSE(RpcDecoder::is_revert(
+      R"({"jsonrpc":"2.0","id":1,"result":"0x0000000000000000000000000000000000000000000000000000000000000002"})"));
+  EXPECT_FALSE(RpcDecoder::is_revert(""));
+}
+
+TEST(RpcDecoderTests, decodeString) {
+  BYTES value;
+  ASSERT_EQ(RpcDecoder::decode_string(encode_string("value1"), value), 0);
+  EXPECT_EQ(std::string((const char *)value.value, value.size), "value1");
+
+  // values longer than one word
+  std::string long_value(100, 'x');
+  ASSERT_EQ(RpcDecoder::decode_string(encode_string(long_value), value), 0);
+  EXPECT_EQ(std::string((const char *)value.value, value.size), long_value);
+
+  ASSERT_EQ(RpcDecoder::decode_string(encode_string(""), value), 0);
+  EXPECT_EQ(value.size, 0U);
+
+  // truncated response
+  std::string truncated = encode_string(long_value);
+  truncated.resize(truncated.size() - 2 * VALUE_SIZE);
+  EXPECT_EQ(RpcDecoder::decode_string(truncated, value), 1);
+  EXPECT_EQ(RpcDecoder::decode_string("zz", value), 1);
+}
+
+TEST(RpcDecoderTests, decodeBatch) {
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {"key1", "value1"},
+      {"key2", ""},
+      {"key3", "a value that is longer than a single word"}};
+
+  std::string keys = int_to_hex(rows.size());
+  std::string values;
+  for (const auto &row : rows) {
+    std::string key = string_to_hex(row.first);
+    keys.append(key + std::string(VALUE_SIZE - key.length(), '0'));
+    values.append(string_to_hex(row.second) + "23232323");
+  }
+  std::string values_length = int_to_hex(values.length() / 2);
+  values.append((VALUE_SIZE - values.length() % VALUE_SIZE) % VALUE_SIZE, '0');
+  std::string abi = int_to_hex(64) + int_to_hex(64 + keys.length() / 2) + keys +
+                    values_length + values;
+
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(RpcDecoder::decode_batch(abi, results), 3);
+  for (const auto &row : rows) {
+    // keys are padded to 32 bytes by the contract
+    BYTES key(32);
+    memset(key.value, 0, key.size);
+    memcpy(key.value, row.first.data(), row.first.length());
+    ASSERT_EQ(results.count(key), 1U);
+    EXPECT_EQ(std::string((const char *)results.at(key).value,
+                          results.at(key).size),
+              row.second);
+  }
+
+  // a missing separator is an invalid response
+  std::map<const BYTES, BYTES> invalid;
+  abi.replace(abi.rfind("23232323"), 8, "00000000");
+  EXPECT_EQ(RpcDecoder::decode_batch(abi, invalid), -1);
+}
+
+TEST(RpcDecoderTests, decodeBytesBatch) {
+  // values of version 2 contracts may contain the former separator
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {"key1", "value1"},
+      {"key2", ""},
+      {"key3", "a value with #### that is longer than a single word"}};
+
+  std::string keys = int_to_hex(rows.size());
+  std::string offsets;
+  std::string values;
+  for (const auto &row : rows) {
+    std::string key = string_to_hex(row.first);
+    keys.append(key + std::string(VALUE_SIZE - key.length(), '0'));
+    offsets.append(int_to_hex(rows.size() * 32 + values.length() / 2));
+    std::string value = string_to_hex(row.second);
+    value.append((VALUE_SIZE - value.length() % VALUE_SIZE) % VALUE_SIZE, '0');
+    values.append(int_to_hex(row.second.length()) + value);
+  }
+  std::string abi = int_to_hex(64) + int_to_hex(64 + keys.length() / 2) + keys +
+                    int_to_hex(rows.size()) + offsets + values;
+
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(RpcDecoder::decode_bytes_batch(abi, results), 3);
+  for (const auto &row : rows) {
+    BYTES key(32);
+    memset(key.value, 0, key.size);
+    memcpy(key.value, row.first.data(), row.first.length());
+    ASSERT_EQ(results.count(key), 1U);
+    EXPECT_EQ(std::string((const char *)results.at(key).value,
+                          results.at(key).size),
+              row.second);
+  }
+
+  // a value exceeding the response is an invalid response
+  std::map<const BYTES, BYTES> invalid;
+  std::string truncated = abi.substr(0, abi.size() - 2 * VALUE_SIZE);
+  EXPECT_EQ(RpcDecoder::decode_bytes_batch(truncated, invalid), -1);
+}
+/** @} */
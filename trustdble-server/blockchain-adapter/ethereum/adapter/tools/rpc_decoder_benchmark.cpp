@@ -0,0 +1,169 @@
+/*! \addtogroup group14
+ *  @{
+ */
+/**
+ * @file
+ * @brief Microbenchmark of the decoding of get and getBatch responses, the
+ * RpcDecoder compared to the former regex and substr based parsing.
+ *
+ * Usage: rpc_decoder_benchmark [<rows per page> [<value size> [<repetitions>]]]
+ */
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "adapter_ethereum/json.hpp"
+#include "adapter_ethereum/rpc_decoder.h"
+#include "adapter_utils/encoding_helpers.h"
+
+/*
+ * ---- Former parsing of the adapter ----------------------------------
+ */
+
+static auto legacy_get(const std::string &response, BYTES &result) -> int {
+  std::regex rgx(".*\"result\":\"0x(\\w+)\".*");
+  std::smatch match;
+  if (std::regex_search(response.begin(), response.end(), match, rgx)) {
+    int val_size =
+        hex_to_int(((std::string)match[1]).substr(VALUE_SIZE, VALUE_SIZE)) * 2;
+    std::string hex_value =
+        ((std::string)match[1]).substr(2 * VALUE_SIZE, val_size);
+    result = BYTES(hex_value.length() / 2);
+    BcAdapter::hex_to_byte_array(hex_value, result.value);
+    return 0;
+  }
+  return 1;
+}
+
+static auto legacy_split(const std::string &response,
+                         int split_length = VALUE_SIZE)
+    -> std::map<const BYTES, BYTES> {
+  std::map<const BYTES, BYTES> ret;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+
+  unsigned long num_keys_values =
+      hex_to_int(response.substr(split_length * 2, split_length));
+  for (unsigned long i = 0; i < num_keys_values; i++) {
+    keys.push_back(response.substr(((i + 3) * split_length), split_length));
+  }
+  std::string result = response.substr((num_keys_values + 4) * split_length);
+  std::string token = "23232323";
+  while (!result.empty()) {
+    auto index = result.find(token);
+    if (index == std::string::npos) {
+      break;
+    }
+    values.push_back(result.substr(0, index));
+    result = result.substr(index + token.size());
+  }
+  for (unsigned long i = 0; i < num_keys_values; i++) {
+    BYTES key_byte(keys.at(i).length() / 2);
+    BYTES value_byte(values.at(i).length() / 2);
+    BcAdapter::hex_to_byte_array(keys.at(i), key_byte.value);
+    BcAdapter::hex_to_byte_array(values.at(i), value_byte.value);
+    ret.emplace(std::move(key_byte), std::move(value_byte));
+  }
+  return ret;
+}
+
+static auto legacy_get_all(const std::string &response,
+                           std::map<const BYTES, BYTES> &results) -> int {
+  auto json = nlohmann::json::parse(response);
+  std::string rpc_result = json["result"];
+  results.merge(legacy_split(rpc_result.substr(2)));
+  return 0;
+}
+
+/*
+ * ---- Benchmark ----------------------------------
+ */
+
+static auto pad(std::string hex) -> std::string {
+  hex.append((VALUE_SIZE - hex.length() % VALUE_SIZE) % VALUE_SIZE, '0');
+  return hex;
+}
+
+//! Response of getBatch with rows of the given value size
+static auto batch_response(size_t rows, size_t value_size) -> std::string {
+  std::string keys = int_to_hex(rows);
+  std::string values;
+  for (size_t i = 0; i < rows; i++) {
+    keys.append(pad(string_to_hex("key" + std::to_string(i))));
+    values.append(string_to_hex(std::string(value_size, 'a' + i % 26)) +
+                  "23232323");
+  }
+  std::string abi = int_to_hex(64) + int_to_hex(64 + keys.length() / 2) +
+                    keys + int_to_hex(values.length() / 2) + pad(values);
+  return R"({"jsonrpc":"2.0","id":1,"result":"0x)" + abi + "\"}";
+}
+
+//! Response of get with a value of the given size
+static auto get_response(size_t value_size) -> std::string {
+  std::string value = string_to_hex(std::string(value_size, 'v'));
+  return R"({"jsonrpc":"2.0","id":1,"result":"0x)" + int_to_hex(32) +
+         int_to_hex(value_size) + pad(value) + "\"}";
+}
+
+template <typename FUNCTION>
+static auto measure(size_t repetitions, FUNCTION function) -> double {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < repetitions; i++) {
+    function();
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(repetitions);
+}
+
+auto main(int argc, char *argv[]) -> int {
+  size_t rows = argc > 1 ? std::stoul(argv[1]) : 100;
+  size_t value_size = argc > 2 ? std::stoul(argv[2]) : 256;
+  size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 100;
+
+  const std::string page = batch_response(rows, value_size);
+  std::map<const BYTES, BYTES> legacy_rows;
+  std::map<const BYTES, BYTES> decoded_rows;
+  legacy_get_all(page, legacy_rows);
+  std::string_view result;
+  if (!RpcDecoder::find_result(page, result) ||
+      RpcDecoder::decode_batch(result, decoded_rows) < 0 ||
+      legacy_rows != decoded_rows) {
+    std::cout << "getBatch: results of the decoders differ" << std::endl;
+    return 1;
+  }
+
+  double legacy_page = measure(repetitions, [&] {
+    std::map<const BYTES, BYTES> results;
+    legacy_get_all(page, results);
+  });
+  double decoder_page = measure(repetitions, [&] {
+    std::map<const BYTES, BYTES> results;
+    std::string_view abi;
+    RpcDecoder::find_result(page, abi);
+    RpcDecoder::decode_batch(abi, results);
+  });
+  std::cout << "getBatch page of " << rows << " rows (" << value_size
+            << " byte values, " << page.size() << " byte response): legacy "
+            << legacy_page << " us, decoder " << decoder_page << " us"
+            << std::endl;
+
+  const std::string get = get_response(value_size);
+  double legacy_value = measure(repetitions * 10, [&] {
+    BYTES value;
+    legacy_get(get, value);
+  });
+  double decoder_value = measure(repetitions * 10, [&] {
+    BYTES value;
+    std::string_view abi;
+    RpcDecoder::find_result(get, abi);
+    RpcDecoder::decode_string(abi, value);
+  });
+  std::cout << "get of a " << value_size << " byte value: legacy "
+            << legacy_value << " us, decoder " << decoder_value << " us"
+            << std::endl;
+  return 0;
+}
+/** @} */
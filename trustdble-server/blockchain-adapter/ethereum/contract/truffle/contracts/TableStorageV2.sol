@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0
+pragma solidity >=0.6.9 <0.9.0;
+pragma experimental ABIEncoderV2;
+
+// Values are stored as bytes and returned as bytes[], so a table scan needs no
+// separator and no concatenation of the values.
+contract TableStorageV2 {
+
+    // tightly packed struct
+    struct Value
+    {
+        uint blocknumber; // indicates when value was written
+        bytes value;
+    }
+
+    mapping(bytes32 => Value) private data;        // data store
+    bytes32[] internal keyList;                    // list of keys
+    mapping(bytes32 => uint) private keyPosition;  // index in keyList + 1
+    uint public lastModified;                      // block of the last write
+
+    // emitted for every written and removed key, the adapter reads the changes
+    // of a table since a block from these logs
+    event Put(bytes32 indexed key, bytes value);
+    event Remove(bytes32 indexed key);
+
+    // version of the storage layout and interface, read by the adapter
+    function version() public pure returns (uint) {
+        return 2;
+    }
+
+    function put(bytes32 key, bytes calldata value) external {
+        store(key, value);
+        lastModified = block.number;
+    }
+
+    function get(bytes32 key) public view returns (bytes memory value) {
+
+        Value storage v = data[key];
+
+        // check if KV exists
+        require(v.blocknumber > 0);
+
+        return v.value;
+    }
+
+    function getSize() public view returns (uint size)
+    {
+        return (keyList.length);
+    }
+
+    function getBatch(uint key_id, uint batch_size) public view returns (bytes32[] memory keys, bytes[] memory values)
+    {
+        // check if KV exists
+        require(key_id < keyList.length);
+
+        uint size = keyList.length-key_id;
+        if(batch_size < size) {
+            size=batch_size;
+        }
+        keys = new bytes32[](size);
+        values = new bytes[](size);
+
+        for(uint i=0; i<size; i++) {
+            keys[i] = keyList[key_id+i];
+            values[i] = data[keys[i]].value;
+        }
+
+        return (keys, values);
+    }
+
+    function remove(bytes32 key) public {
+
+        uint position = keyPosition[key];
+
+        // check if key exists
+        require(position > 0);
+
+        // move last element to position of key to delete, then call pop()
+        bytes32 last = keyList[keyList.length - 1];
+        keyList[position - 1] = last;
+        keyPosition[last] = position;
+        keyList.pop();
+
+        delete keyPosition[key];
+        delete data[key];
+        lastModified = block.number;
+        emit Remove(key);
+    }
+
+    function putBatch(bytes32[] calldata keys, bytes[] calldata values) external {
+        require(keys.length == values.length);
+        for (uint i = 0; i < keys.length; i++) {
+            store(keys[i], values[i]);
+        }
+        lastModified = block.number;
+    }
+
+    function store(bytes32 key, bytes calldata value) private {
+        if(keyPosition[key] == 0) {
+            keyList.push(key);
+            keyPosition[key] = keyList.length;
+        }
+
+        // persist data in blockchain
+        data[key] = Value(block.number, value);
+        emit Put(key, value);
+    }
+}
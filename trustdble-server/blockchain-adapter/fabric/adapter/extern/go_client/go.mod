@@ -4,5 +4,7 @@ go 1.14
 
 require (
 	github.com/hyperledger/fabric-gateway v1.1.0
+	github.com/hyperledger/fabric-protos-go-apiv2 v0.0.0-20220615102044-467be1c7b2e7
 	google.golang.org/grpc v1.46.2
+	google.golang.org/protobuf v1.28.0
 )
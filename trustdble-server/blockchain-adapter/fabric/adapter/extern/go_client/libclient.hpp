@@ -19,6 +19,10 @@ typedef struct { const char *p; ptrdiff_t n; } _GoString_;
 /* Start of preamble from import "C" comments.  */
 
 
+#line 9 "trustdbleClient.go"
+ #include <stdlib.h>
+
+#line 1 "cgo-generated-wrapper"
 
 
 /* End of preamble from import "C" comments.  */
@@ -74,17 +78,89 @@ typedef struct { void *data; GoInt len; GoInt cap; } GoSlice;
 extern "C" {
 #endif
 
-extern GoInt Init(GoString channel, GoString contractName, GoString mspID, GoString certPath, GoString keyPath, GoString tlsCertPath, GoString peerEndpoint, GoString gatewayPeer);
-extern GoInt Close(GoString contractName, GoString gatewayPeer);
-extern GoInt Write(GoString json_value, GoString function, GoString tableName, GoString gatewayPeer);
+
+/* Return type for Init */
+struct Init_return {
+	GoInt r0;
+	GoInt r1;
+};
+
+// Init opens a contract. All contracts of the same peer and client identity
+// share one gateway connection, which is opened by the first of them. Returns
+// the handle of the contract and a status code.
+//
+extern struct Init_return Init(GoString channel, GoString contractName, GoString mspID, GoString certPath, GoString keyPath, GoString tlsCertPath, GoString peerEndpoint, GoString gatewayPeer);
+
+// Close releases a contract handle and closes the gateway connection once
+// its last contract is closed
+//
+extern GoInt Close(GoInt contractHandle);
+
+/* Return type for Committed */
+struct Committed_return {
+	char* r0;
+	GoInt r1;
+	GoInt r2;
+};
+
+// Committed queries the chaincode definition committed on the channel of a
+// contract handle (QueryChaincodeDefinition of _lifecycle). Returns the version
+// and sequence of the definition and a status code, which is 1 if it is
+// missing or can't be queried. The version is allocated with malloc and has to
+// be freed by the caller.
+//
+extern struct Committed_return Committed(GoInt contractHandle, GoString contractName);
+
+// Write submits a transaction with a frame of records: key-value pairs for
+// put and keys for delete
+//
+extern GoInt Write(GoSlice records, GoString function, GoString tableName, GoInt contractHandle);
+
+/* Return type for SubmitAsync */
+struct SubmitAsync_return {
+	char* r0;
+	GoInt r1;
+};
+
+// SubmitAsync endorses a transaction with a frame of records like Write and
+// sends it to the orderer without waiting until it is committed. Returns the
+// id of the transaction, which has to be passed to AwaitCommits, and a status
+// code. The id is allocated with malloc and has to be freed by the caller.
+//
+extern struct SubmitAsync_return SubmitAsync(GoSlice records, GoString function, GoString tableName, GoInt contractHandle);
+
+// AwaitCommits waits for the commit status of a frame of transaction ids
+// returned by SubmitAsync, all of them concurrently. Returns 0 if all of them
+// are committed as valid transactions, 1 otherwise.
+//
+extern GoInt AwaitCommits(GoSlice transactionIDs);
 
 /* Return type for Read */
 struct Read_return {
-	char* r0;
+	void* r0;
 	GoInt r1;
 	GoInt r2;
 };
-extern struct Read_return Read(GoString json_value, GoString function, GoString tableName, GoString gatewayPeer);
+
+// Read evaluates get, returning the value of a key. The value is allocated
+// with malloc and has to be freed by the caller.
+//
+extern struct Read_return Read(GoSlice key, GoString function, GoString tableName, GoInt contractHandle);
+
+/* Return type for ReadPage */
+struct ReadPage_return {
+	void* r0;
+	GoInt r1;
+	char* r2;
+	GoInt r3;
+};
+
+// ReadPage evaluates getPage, returning a frame of at most pageSize key-value
+// pairs of a table and the bookmark of the next page, which is empty after
+// the last page. Frame and bookmark are allocated with malloc and have to be
+// freed by the caller.
+//
+extern struct ReadPage_return ReadPage(GoString tableName, GoInt pageSize, GoString bookmark, GoInt contractHandle);
 
 #ifdef __cplusplus
 }
@@ -6,34 +6,57 @@ SPDX-License-Identifier: Apache-2.0
 
 package main
 
+// #include <stdlib.h>
 import "C"
 
 import (
 	"crypto/x509"
+	"encoding/binary"
+	"encoding/hex"
+	"encoding/json"
 	"fmt"
 	"github.com/hyperledger/fabric-gateway/pkg/client"
 	"github.com/hyperledger/fabric-gateway/pkg/identity"
+	"github.com/hyperledger/fabric-protos-go-apiv2/peer/lifecycle"
 	"google.golang.org/grpc"
 	"google.golang.org/grpc/credentials"
+	"google.golang.org/protobuf/proto"
 	"io/fs"
 	"io/ioutil"
 	"log"
 	"os"
 	"path"
+	"strconv"
 	"strings"
 	"sync"
+	"unsafe"
 )
 
-type conn struct {
-	grpcConnection *grpc.ClientConn
+// gateway is a gRPC and gateway connection to a peer with one client
+// identity, shared by all contracts opened with the same peer and identity
+type gateway struct {
+	grpcConnection    *grpc.ClientConn
 	gatewayConnection *client.Gateway
-	channel string
-	contractName string
-	users int
+	users             int
 }
 
-var connections map[string]*conn = make(map[string]*conn)
-var connectionsMutex sync.RWMutex
+// handle is a contract opened with Init, identified by the number returned to
+// the C++ client
+type handle struct {
+	gatewayKey string
+	network    *client.Network
+	contract   *client.Contract
+}
+
+var gateways map[string]*gateway = make(map[string]*gateway)
+var handles map[int]*handle = make(map[int]*handle)
+var nextHandle int = 1
+var registryMutex sync.RWMutex
+
+// commits are the transactions sent with SubmitAsync, by transaction id,
+// until their commit status is awaited
+var commits map[string]*client.Commit = make(map[string]*client.Commit)
+var commitsMutex sync.Mutex
 
 // newGrpcConnection create a new gRPC connection to the Gateway server.
 func newGrpcConnection(tlsCertPath, peerEndpoint, gatewayPeer string) (*grpc.ClientConn, error) {
@@ -121,95 +144,259 @@ func readDir(dirname string) ([]fs.FileInfo, error) {
 	return ioutil.ReadDir(absoluteDirname)
 }
 
-//export Init
-func Init(channel, contractName, mspID, certPath, keyPath, tlsCertPath, peerEndpoint, gatewayPeer string) int {
-	log.Println("============ initializing go client ============")
+// gatewayKey identifies the connection of a peer and client identity
+func gatewayKey(mspID, certPath, tlsCertPath, peerEndpoint, gatewayPeer string) string {
+	return strings.Join([]string{peerEndpoint, gatewayPeer, tlsCertPath, mspID, certPath}, "|")
+}
+
+// connectGateway opens the gRPC and gateway connection of a peer and client
+// identity
+func connectGateway(mspID, certPath, keyPath, tlsCertPath, peerEndpoint, gatewayPeer string) (*gateway, error) {
+	log.Println("============ building grpc connection ============")
+	clientConnection, err := newGrpcConnection(tlsCertPath, peerEndpoint, gatewayPeer)
+	if err != nil {
+		return nil, fmt.Errorf("failed to establish grpc connection: %w", err)
+	}
 
-	connectionsMutex.Lock()
-	defer connectionsMutex.Unlock()
-	connection, ok := connections[gatewayPeer]
+	id, err := newIdentity(mspID, certPath)
+	if err != nil {
+		clientConnection.Close()
+		return nil, fmt.Errorf("failed to create new client identiy: %w", err)
+	}
+
+	sign, err := newSign(keyPath)
+	if err != nil {
+		clientConnection.Close()
+		return nil, fmt.Errorf("failed to create function for signing with clients private key: %w", err)
+	}
+
+	// Create a Gateway connection for a specific client identity
+	gatewayConnection, err := client.Connect(
+		id,
+		client.WithSign(sign),
+		client.WithClientConnection(clientConnection),
+	)
+	if err != nil {
+		clientConnection.Close()
+		return nil, fmt.Errorf("failed to connect to gateway: %w", err)
+	}
+	return &gateway{clientConnection, gatewayConnection, 0}, nil
+}
+
+// lookupHandle returns the network and contract of a handle
+func lookupHandle(contractHandle int) (*handle, bool) {
+	registryMutex.RLock()
+	defer registryMutex.RUnlock()
+	h, ok := handles[contractHandle]
 	if !ok {
-		log.Println("============ building grpc connection ============")
-		clientConnection, err := newGrpcConnection(tlsCertPath, peerEndpoint, gatewayPeer)
-		if err != nil {
-			log.Printf("Failed to establish grpc connection: %v", err)
-			return 1
-		}
+		log.Printf("The client hasn't been initialized for handle %v", contractHandle)
+		return nil, false
+	}
+	return h, true
+}
 
-		id, err := newIdentity(mspID, certPath)
-		if err != nil {
-			log.Printf("Failed to create new client identiy: %v", err)
-			return 1
-		}
+// lookupContract returns the contract of a handle
+func lookupContract(contractHandle int) (*client.Contract, bool) {
+	h, ok := lookupHandle(contractHandle)
+	if !ok {
+		return nil, false
+	}
+	return h.contract, true
+}
 
-		sign, err := newSign(keyPath)
-		if err != nil {
-			log.Printf("Failed to create function for signing with clients private key: %v", err)
-			return 1
-		}
+// Init opens a contract. All contracts of the same peer and client identity
+// share one gateway connection, which is opened by the first of them. Returns
+// the handle of the contract and a status code.
+//
+//export Init
+func Init(channel, contractName, mspID, certPath, keyPath, tlsCertPath, peerEndpoint, gatewayPeer string) (int, int) {
+	log.Println("============ initializing go client ============")
+
+	key := gatewayKey(mspID, certPath, tlsCertPath, peerEndpoint, gatewayPeer)
 
-		// Create a Gateway connection for a specific client identity
-		gatewayConnection, err := client.Connect(
-			id,
-			client.WithSign(sign),
-			client.WithClientConnection(clientConnection),
-		)
+	registryMutex.Lock()
+	defer registryMutex.Unlock()
+	connection, ok := gateways[key]
+	if !ok {
+		var err error
+		connection, err = connectGateway(mspID, certPath, keyPath, tlsCertPath, peerEndpoint, gatewayPeer)
 		if err != nil {
-			log.Printf("Failed to connect to gateway: %v", err)
-			return 1
+			log.Printf("Failed to open gateway connection: %v", err)
+			return 0, 1
 		}
-		connection = &conn{clientConnection, gatewayConnection, channel, contractName, 1}
-		connections[gatewayPeer] = connection
-
-		return 0
+		gateways[key] = connection
 	}
-
 	connection.users += 1
 
-	return 0
+	network := connection.gatewayConnection.GetNetwork(channel)
+	contractHandle := nextHandle
+	nextHandle += 1
+	handles[contractHandle] = &handle{key, network, network.GetContract(contractName)}
+
+	return contractHandle, 0
 }
 
+// Close releases a contract handle and closes the gateway connection once
+// its last contract is closed
+//
 //export Close
-func Close(contractName, gatewayPeer string) int {
+func Close(contractHandle int) int {
 
 	log.Println("============ closing go client ============")
-	connectionsMutex.Lock()
-	defer connectionsMutex.Unlock()
-	connection, ok := connections[gatewayPeer]
+	registryMutex.Lock()
+	defer registryMutex.Unlock()
+	h, ok := handles[contractHandle]
 	if !ok {
-		log.Printf("The client hasn't been initialized for gateway peer %v", gatewayPeer)
+		log.Printf("The client hasn't been initialized for handle %v", contractHandle)
 		return 1
 	}
+	delete(handles, contractHandle)
 
+	connection := gateways[h.gatewayKey]
 	connection.users -= 1
 
 	if connection.users == 0 {
 		log.Println("============ closing grpc connection ============")
 		connection.gatewayConnection.Close()
 		connection.grpcConnection.Close()
-		delete(connections, gatewayPeer)
+		delete(gateways, h.gatewayKey)
 	}
 
 	return 0
 }
 
+// Committed queries the chaincode definition committed on the channel of a
+// contract handle (QueryChaincodeDefinition of _lifecycle). Returns the version
+// and sequence of the definition and a status code, which is 1 if it is
+// missing or can't be queried. The version is allocated with malloc and has to
+// be freed by the caller.
+//
+//export Committed
+func Committed(contractHandle int, contractName string) (*C.char, int, int) {
+
+	log.Println("============ query committed " + contractName + " ============")
+
+	h, ok := lookupHandle(contractHandle)
+	if !ok {
+		return nil, 0, 1
+	}
+
+	args, err := proto.Marshal(&lifecycle.QueryChaincodeDefinitionArgs{Name: contractName})
+	if err != nil {
+		log.Printf("Failed to marshal query arguments: %v", err)
+		return nil, 0, 1
+	}
+	value, err := h.network.GetContract("_lifecycle").Evaluate("QueryChaincodeDefinition", client.WithBytesArguments(args))
+	if err != nil {
+		// e.g. the chaincode is not defined on the channel yet
+		log.Printf("Failed to query chaincode definition: %v", err)
+		return nil, 0, 1
+	}
+
+	definition := &lifecycle.QueryChaincodeDefinitionResult{}
+	if err := proto.Unmarshal(value, definition); err != nil {
+		log.Printf("Failed to unmarshal chaincode definition: %v", err)
+		return nil, 0, 1
+	}
+	return C.CString(definition.GetVersion()), int(definition.GetSequence()), 0
+}
+
+// Batches cross the cgo boundary as frames of records. Each record is its
+// length as 4 byte little endian integer followed by its bytes. A frame of
+// key-value pairs alternates key and value records.
+const recordLengthSize = 4
+
+// decodeRecords splits a frame into its records, which refer to the frame
+func decodeRecords(frame []byte) ([][]byte, error) {
+	var records [][]byte
+	for len(frame) > 0 {
+		if len(frame) < recordLengthSize {
+			return nil, fmt.Errorf("truncated record length")
+		}
+		length := int(binary.LittleEndian.Uint32(frame))
+		frame = frame[recordLengthSize:]
+		if len(frame) < length {
+			return nil, fmt.Errorf("truncated record of %v bytes", length)
+		}
+		records = append(records, frame[:length:length])
+		frame = frame[length:]
+	}
+	return records, nil
+}
+
+// encodeRecords writes records into a frame allocated with malloc, which the
+// caller has to free
+func encodeRecords(records [][]byte) (unsafe.Pointer, int) {
+	size := 0
+	for _, record := range records {
+		size += recordLengthSize + len(record)
+	}
+	if size == 0 {
+		return nil, 0
+	}
+	frame := C.malloc(C.size_t(size))
+	out := (*[1 << 30]byte)(frame)[:size:size]
+	pos := 0
+	for _, record := range records {
+		binary.LittleEndian.PutUint32(out[pos:], uint32(len(record)))
+		pos += recordLengthSize
+		pos += copy(out[pos:], record)
+	}
+	return frame, size
+}
+
+// chaincodeArgument converts the records of a write into the hex encoded JSON
+// argument of the chaincode function
+func chaincodeArgument(function string, records [][]byte) (string, error) {
+	var argument []byte
+	var err error
+	switch function {
+	case "put":
+		if len(records)%2 != 0 {
+			return "", fmt.Errorf("key without value")
+		}
+		pairs := make(map[string]string, len(records)/2)
+		for i := 0; i < len(records); i += 2 {
+			pairs[hex.EncodeToString(records[i])] = hex.EncodeToString(records[i+1])
+		}
+		argument, err = json.Marshal(pairs)
+	case "delete":
+		keys := make([]string, len(records))
+		for i, record := range records {
+			keys[i] = hex.EncodeToString(record)
+		}
+		argument, err = json.Marshal(keys)
+	default:
+		return "", fmt.Errorf("unknown function %v", function)
+	}
+	return string(argument), err
+}
+
+// Write submits a transaction with a frame of records: key-value pairs for
+// put and keys for delete
+//
 //export Write
-func Write(json_value, function, tableName, gatewayPeer string) int {
+func Write(records []byte, function, tableName string, contractHandle int) int {
 
 	log.Println("============ " + function + " ============")
 
-	connectionsMutex.RLock()
-	defer connectionsMutex.RUnlock()
-	connection, ok := connections[gatewayPeer]
+	contract, ok := lookupContract(contractHandle)
 	if !ok {
-		log.Printf("The client hasn't been initialized for gateway peer %v", gatewayPeer)
 		return 1
 	}
 
-	network := connection.gatewayConnection.GetNetwork(connection.channel)
-	contract := network.GetContract(connection.contractName)
+	decoded, err := decodeRecords(records)
+	if err != nil {
+		log.Printf("Failed to decode records: %v", err)
+		return 1
+	}
+	argument, err := chaincodeArgument(function, decoded)
+	if err != nil {
+		log.Printf("Failed to encode %v argument: %v", function, err)
+		return 1
+	}
 
-	_, err := contract.SubmitTransaction(function, tableName, json_value)
+	_, err = contract.SubmitTransaction(function, tableName, argument)
 	if err != nil {
 		log.Printf("Failed to submit transaction: %v", err)
 		return 1
@@ -218,28 +405,178 @@ func Write(json_value, function, tableName, gatewayPeer string) int {
 	return 0
 }
 
+// SubmitAsync endorses a transaction with a frame of records like Write and
+// sends it to the orderer without waiting until it is committed. Returns the
+// id of the transaction, which has to be passed to AwaitCommits, and a status
+// code. The id is allocated with malloc and has to be freed by the caller.
+//
+//export SubmitAsync
+func SubmitAsync(records []byte, function, tableName string, contractHandle int) (*C.char, int) {
+
+	log.Println("============ " + function + " async ============")
+
+	contract, ok := lookupContract(contractHandle)
+	if !ok {
+		return nil, 1
+	}
+
+	decoded, err := decodeRecords(records)
+	if err != nil {
+		log.Printf("Failed to decode records: %v", err)
+		return nil, 1
+	}
+	argument, err := chaincodeArgument(function, decoded)
+	if err != nil {
+		log.Printf("Failed to encode %v argument: %v", function, err)
+		return nil, 1
+	}
+
+	_, commit, err := contract.SubmitAsync(function, client.WithArguments(tableName, argument))
+	if err != nil {
+		log.Printf("Failed to submit transaction: %v", err)
+		return nil, 1
+	}
+
+	transactionID := commit.TransactionID()
+	commitsMutex.Lock()
+	commits[transactionID] = commit
+	commitsMutex.Unlock()
+	return C.CString(transactionID), 0
+}
+
+// AwaitCommits waits for the commit status of a frame of transaction ids
+// returned by SubmitAsync, all of them concurrently. Returns 0 if all of them
+// are committed as valid transactions, 1 otherwise.
+//
+//export AwaitCommits
+func AwaitCommits(transactionIDs []byte) int {
+
+	log.Println("============ await commits ============")
+
+	decoded, err := decodeRecords(transactionIDs)
+	if err != nil {
+		log.Printf("Failed to decode transaction ids: %v", err)
+		return 1
+	}
+
+	failed := false
+	var failedMutex sync.Mutex
+	var wait sync.WaitGroup
+	for _, record := range decoded {
+		transactionID := string(record)
+		commitsMutex.Lock()
+		commit, ok := commits[transactionID]
+		delete(commits, transactionID)
+		commitsMutex.Unlock()
+		if !ok {
+			log.Printf("Unknown transaction %v", transactionID)
+			// goroutines of earlier ids may set failed concurrently
+			failedMutex.Lock()
+			failed = true
+			failedMutex.Unlock()
+			continue
+		}
+
+		wait.Add(1)
+		go func() {
+			defer wait.Done()
+			status, err := commit.Status()
+			if err == nil && status.Successful {
+				return
+			}
+			if err != nil {
+				log.Printf("Failed to get commit status of transaction %v: %v", transactionID, err)
+			} else {
+				log.Printf("Transaction %v failed to commit with status code %v", transactionID, status.Code)
+			}
+			failedMutex.Lock()
+			failed = true
+			failedMutex.Unlock()
+		}()
+	}
+	wait.Wait()
+
+	if failed {
+		return 1
+	}
+	return 0
+}
+
+// Read evaluates get, returning the value of a key. The value is allocated
+// with malloc and has to be freed by the caller.
+//
 //export Read
-func Read(json_value, function string, tableName, gatewayPeer string) (*C.char, int, int) {
+func Read(key []byte, function string, tableName string, contractHandle int) (unsafe.Pointer, int, int) {
 
 	log.Println("============ " + function + " ============")
 
-	connectionsMutex.RLock()
-	defer connectionsMutex.RUnlock()
-	connection, ok := connections[gatewayPeer]
+	contract, ok := lookupContract(contractHandle)
 	if !ok {
-		log.Printf("The client hasn't been initialized for gateway peer %v", gatewayPeer)
 		return nil, 0, 1
 	}
 
-	network := connection.gatewayConnection.GetNetwork(connection.channel)
-	contract := network.GetContract(connection.contractName)
-
-	value, err := contract.EvaluateTransaction(function, tableName, json_value)
+	value, err := contract.EvaluateTransaction(function, tableName, hex.EncodeToString(key))
 	if err != nil {
 		log.Printf("Failed to evaluate transaction: %v", err)
 		return nil, 0, 1
 	}
-	return C.CString(string(value)), len(value), 0
+
+	decoded, err := hex.DecodeString(string(value))
+	if err != nil {
+		log.Printf("Failed to decode value: %v", err)
+		return nil, 0, 1
+	}
+	return C.CBytes(decoded), len(decoded), 0
+}
+
+// page is the result of the getPage function of the chaincode
+type page struct {
+	Bookmark string            `json:"bookmark"`
+	Pairs    map[string]string `json:"pairs"`
+}
+
+// ReadPage evaluates getPage, returning a frame of at most pageSize key-value
+// pairs of a table and the bookmark of the next page, which is empty after
+// the last page. Frame and bookmark are allocated with malloc and have to be
+// freed by the caller.
+//
+//export ReadPage
+func ReadPage(tableName string, pageSize int, bookmark string, contractHandle int) (unsafe.Pointer, int, *C.char, int) {
+
+	log.Println("============ getPage ============")
+
+	contract, ok := lookupContract(contractHandle)
+	if !ok {
+		return nil, 0, nil, 1
+	}
+
+	value, err := contract.EvaluateTransaction("getPage", tableName, strconv.Itoa(pageSize), bookmark)
+	if err != nil {
+		log.Printf("Failed to evaluate transaction: %v", err)
+		return nil, 0, nil, 1
+	}
+
+	var result page
+	if err := json.Unmarshal(value, &result); err != nil {
+		log.Printf("Failed to parse getPage result: %v", err)
+		return nil, 0, nil, 1
+	}
+	records := make([][]byte, 0, 2*len(result.Pairs))
+	for hexKey, hexValue := range result.Pairs {
+		key, err := hex.DecodeString(hexKey)
+		if err != nil {
+			log.Printf("Failed to decode key: %v", err)
+			return nil, 0, nil, 1
+		}
+		value, err := hex.DecodeString(hexValue)
+		if err != nil {
+			log.Printf("Failed to decode value: %v", err)
+			return nil, 0, nil, 1
+		}
+		records = append(records, key, value)
+	}
+	frame, size := encodeRecords(records)
+	return frame, size, C.CString(result.Bookmark), 0
 }
 
 // empty main is needed
@@ -0,0 +1,129 @@
+package main
+
+import (
+	"bytes"
+	"encoding/hex"
+	"encoding/json"
+	"testing"
+)
+
+// frame builds a frame of records like the FabricClient does
+func frame(records ...string) []byte {
+	var out []byte
+	for _, record := range records {
+		length := len(record)
+		out = append(out, byte(length), byte(length>>8), byte(length>>16), byte(length>>24))
+		out = append(out, record...)
+	}
+	return out
+}
+
+func TestDecodeRecords(t *testing.T) {
+	records, err := decodeRecords(nil)
+	if err != nil || len(records) != 0 {
+		t.Fatalf("empty frame: got %v, %v", records, err)
+	}
+
+	// zero-length and binary records
+	want := []string{"key", "", "\x00\xff"}
+	records, err = decodeRecords(frame(want...))
+	if err != nil {
+		t.Fatalf("decodeRecords failed: %v", err)
+	}
+	if len(records) != len(want) {
+		t.Fatalf("got %v records, want %v", len(records), len(want))
+	}
+	for i, record := range records {
+		if string(record) != want[i] {
+			t.Errorf("record %v: got %q, want %q", i, record, want[i])
+		}
+		// a record must not grow into the following one
+		if cap(record) != len(record) {
+			t.Errorf("record %v: capacity %v exceeds its length", i, cap(record))
+		}
+	}
+}
+
+func TestDecodeTruncatedRecords(t *testing.T) {
+	truncated := map[string][]byte{
+		"length prefix":         {0x01, 0x00, 0x00},
+		"length after a record": append(frame("key"), 0x01),
+		"record":                frame("value")[:6],
+		"length beyond 2^31":    {0xff, 0xff, 0xff, 0xff, 'a'},
+	}
+	for name, input := range truncated {
+		if records, err := decodeRecords(input); err == nil {
+			t.Errorf("truncated %v: got %v without error", name, records)
+		}
+	}
+}
+
+func TestEncodeRecords(t *testing.T) {
+	if pointer, size := encodeRecords(nil); pointer != nil || size != 0 {
+		t.Fatalf("empty frame: got %v, %v", pointer, size)
+	}
+
+	// the frame is allocated with malloc, the test leaves it to the process
+	records := [][]byte{[]byte("key"), {}, []byte("value")}
+	pointer, size := encodeRecords(records)
+	encoded := (*[1 << 30]byte)(pointer)[:size:size]
+	if want := frame("key", "", "value"); !bytes.Equal(encoded, want) {
+		t.Fatalf("got %v, want %v", encoded, want)
+	}
+	decoded, err := decodeRecords(encoded)
+	if err != nil || len(decoded) != len(records) {
+		t.Fatalf("round trip: got %v, %v", decoded, err)
+	}
+	for i := range records {
+		if !bytes.Equal(decoded[i], records[i]) {
+			t.Errorf("record %v: got %q, want %q", i, decoded[i], records[i])
+		}
+	}
+}
+
+func TestChaincodeArgumentPut(t *testing.T) {
+	records := [][]byte{[]byte("k1"), []byte("v1"), []byte("k2"), {}}
+	argument, err := chaincodeArgument("put", records)
+	if err != nil {
+		t.Fatalf("chaincodeArgument failed: %v", err)
+	}
+	var pairs map[string]string
+	if err := json.Unmarshal([]byte(argument), &pairs); err != nil {
+		t.Fatalf("argument %v is no JSON object: %v", argument, err)
+	}
+	want := map[string]string{
+		hex.EncodeToString([]byte("k1")): hex.EncodeToString([]byte("v1")),
+		hex.EncodeToString([]byte("k2")): "",
+	}
+	if len(pairs) != len(want) {
+		t.Fatalf("got %v, want %v", pairs, want)
+	}
+	for key, value := range want {
+		if pairs[key] != value {
+			t.Errorf("key %v: got %q, want %q", key, pairs[key], value)
+		}
+	}
+
+	if _, err := chaincodeArgument("put", records[:3]); err == nil {
+		t.Errorf("key without value: no error")
+	}
+}
+
+func TestChaincodeArgumentDelete(t *testing.T) {
+	argument, err := chaincodeArgument("delete", [][]byte{[]byte("k1"), {0x00, 0xff}})
+	if err != nil {
+		t.Fatalf("chaincodeArgument failed: %v", err)
+	}
+	if want := `["6b31","00ff"]`; argument != want {
+		t.Errorf("got %v, want %v", argument, want)
+	}
+
+	argument, err = chaincodeArgument("delete", nil)
+	if err != nil || argument != "[]" {
+		t.Errorf("no keys: got %v, %v", argument, err)
+	}
+
+	if _, err := chaincodeArgument("get", nil); err == nil {
+		t.Errorf("unknown function: no error")
+	}
+}
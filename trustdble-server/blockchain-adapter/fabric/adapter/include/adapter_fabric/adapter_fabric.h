@@ -21,6 +21,9 @@
 #include "config_fabric.h"
 
 const std::string kSeparatorToken = "##";
+//! Version of the chaincode deployed by the adapter, change it to redeploy a
+//! changed chaincode
+const std::string kChaincodeVersion = "1.1";
 
 /**
  * @brief BC_Adapter implementation for Hyperledger Fabric.
@@ -44,6 +47,14 @@ class FabricAdapter : public BcAdapter {
   auto shutdown() -> bool override;
 
   auto put(std::map<const BYTES, const BYTES> &batch) -> int override;
+  // clang-format off
+  //! @copydoc BcAdapter::put_async(std::map<const BYTES, const BYTES> &batch, std::vector<std::string> &transactions)
+  auto put_async(std::map<const BYTES, const BYTES> &batch,
+                 std::vector<std::string> &transactions) -> int override;
+  //! @copydoc BcAdapter::await_puts(const std::vector<std::string> &transactions)
+  // clang-format on
+  auto await_puts(const std::vector<std::string> &transactions)
+      -> int override;
   auto get(const BYTES &key, BYTES &result) -> int override;
   // clang-format off
   //! @copydoc BcAdapter::get_all(std::map<const BYTES, BYTES> &results)
@@ -64,6 +75,16 @@ class FabricAdapter : public BcAdapter {
   auto drop_table() -> int override;
 
  private:
+  /**
+   * @brief Deploy the chaincode to the channel unless its definition is
+   * already committed. The result is remembered per channel, so only the
+   * first table of a channel in the process queries the definition.
+   *
+   * @param contract_name Name of the chaincode
+   * @return status code (0 on sucess, 1 on faiure)
+   */
+  auto deploy_contract(const std::string &contract_name) -> int;
+
   std::string tableName_;
   FabricConfig config_;
 
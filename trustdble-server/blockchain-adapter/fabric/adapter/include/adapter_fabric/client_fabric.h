@@ -5,6 +5,7 @@
 #ifndef CLIENT_FABRIC_H
 #define CLIENT_FABRIC_H
 
+#include <cstdint>
 #include <cstring>
 #include <list>
 #include <map>
@@ -20,10 +21,10 @@
  *
  * Provides functions to:
  *
- *      - put key value pair to ledger
+ *      - put key value pair to ledger, also without waiting for the commit
  *      - get value of key from ledger
  *      - remove a key and its value
- *      - get all key value pairs on the ledger
+ *      - get all key value pairs on the ledger, page by page
  */
 class FabricClient {
  public:
@@ -35,7 +36,9 @@ class FabricClient {
   // Mapped contract methods
 
   /**
-   * @brief Initialize the client using the passe parameters
+   * @brief Initialize the client using the passe parameters. The gateway
+   * connection is shared by all clients of the same peer and client identity
+   * in the process, it is opened by the first and closed by the last of them.
    *
    * @param channel_name Name of the fabric channel to connect to
    * @param contract_name Name of the contract to connect to for reads/writes
@@ -62,6 +65,30 @@ class FabricClient {
    */
   auto put(std::map<const BYTES, const BYTES> &batch) -> int;
 
+  /**
+   * @brief Endorse a batch of key-value pairs and send it to the orderer
+   * without waiting until it is committed
+   *
+   * @param batch Batch including multiple key-value pairs
+   * @param transaction_id Return parameter containing the id of the
+   * transaction, which has to be passed to awaitCommits()
+   *
+   * @return Returns a status code. 0 for success and 1 for errors
+   */
+  auto submitPut(std::map<const BYTES, const BYTES> &batch,
+                 std::string &transaction_id) -> int;
+
+  /**
+   * @brief Waits until transactions sent with submitPut() are committed, the
+   * commit status of all of them is awaited concurrently
+   *
+   * @param transaction_ids Ids of the transactions
+   *
+   * @return Returns a status code. 0 if all transactions are committed as
+   * valid and 1 for errors
+   */
+  auto awaitCommits(const std::vector<std::string> &transaction_ids) -> int;
+
   /**
    * @brief Reads a value specified by key from the ledger
    *
@@ -73,14 +100,31 @@ class FabricClient {
   auto get(const BYTES &key, BYTES &value) -> int;
 
   /**
-   * @brief Reads all keys and values from the ledger
+   * @brief Reads all keys and values from the ledger, page by page with a
+   * FabricPageIterator
    *
    * @param values Return parameter containing a map of all
    * key-value pairs on the ledger
+   * @param page_size Maximum number of key-value pairs read per page
    *
    * @return Returns a status code. 0 for success and 1 for errors
    */
-  auto getAll(std::map<const BYTES, BYTES> &values) -> int;
+  auto getAll(std::map<const BYTES, BYTES> &values, int64_t page_size) -> int;
+
+  /**
+   * @brief Reads a page of the keys and values from the ledger
+   *
+   * @param page_size Maximum number of key-value pairs of the page
+   * @param bookmark Bookmark of the page, empty for the first page
+   * @param values Return parameter containing the key-value pairs of the page
+   * @param next_bookmark Return parameter containing the bookmark of the next
+   * page, empty after the last page
+   *
+   * @return Returns a status code. 0 for success and 1 for errors
+   */
+  auto getPage(int64_t page_size, const std::string &bookmark,
+               std::map<const BYTES, BYTES> &values,
+               std::string &next_bookmark) -> int;
 
   /**
    * @brief Removes all given keys and their values from the ledger
@@ -91,6 +135,20 @@ class FabricClient {
    */
   auto remove(std::list<BYTES> &batch) -> int;
 
+  /**
+   * @brief Reads the chaincode definition committed on the channel of the
+   * client
+   *
+   * @param contract_name Name of the chaincode
+   * @param version Return parameter containing the version of the definition
+   * @param sequence Return parameter containing the sequence of the definition
+   *
+   * @return Returns a status code. 0 for success and 1 if the definition is
+   * missing or can't be queried
+   */
+  auto committedDefinition(const std::string &contract_name,
+                           std::string &version, int64_t &sequence) -> int;
+
   /**
    * @brief Closes client
    *
@@ -108,14 +166,8 @@ class FabricClient {
   [[nodiscard]] auto isInit() const -> bool;
 
  private:
-  std::string channel_name_;
-  std::string contract_name_;
-  std::string msp_id_;
-  std::string cert_path_;
-  std::string key_path_;
-  std::string tls_cert_path_;
-  std::string gateway_peer_;
-  std::string peer_endpoint_;
+  //! Handle of the contract opened by the go client
+  int64_t handle_ = 0;
   std::string table_name_;
   bool isInitializied_ = false;
 };
@@ -8,6 +8,9 @@
 #include "adapter_interface/adapter_config.h"
 #include "json.hpp"
 
+// number of rows of a page of a table scan by default
+#define DEFAULT_SCAN_PAGE_SIZE 1000
+
 /**
  * @brief Define specific configuration values for the Fabric adapter
  *
@@ -72,6 +75,16 @@ class FabricConfig : public AdapterConfig {
     return config_.get<std::string>("Adapter-Fabric.adapters-path");
   }
 
+  /**
+   * @brief The maximum number of rows of a page of a table scan (optional)
+   *
+   * @return int
+   */
+  auto scan_page_size() -> int {
+    return config_.get<int>("Adapter-Fabric.scan-page-size",
+                            DEFAULT_SCAN_PAGE_SIZE);
+  }
+
   /**
    * @brief Name of fabric network's channel
    *
@@ -0,0 +1,76 @@
+/** @defgroup group35 page_iterator
+ *  @ingroup group3
+ *  @{
+ */
+#ifndef PAGE_ITERATOR_H
+#define PAGE_ITERATOR_H
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <string>
+
+#include "adapter_interface/adapter_interface.h"
+#include "client_fabric.h"
+
+/**
+ * @brief Iterator over the pages of a table scan on Hyperledger Fabric.
+ *
+ * Each page is a range query of the chaincode (getPage), continued with the
+ * bookmark of the previous page. While the caller consumes a page, the next
+ * one is fetched in the background, so at most two pages are held in memory
+ * and no single response has to contain the whole table.
+ */
+class FabricPageIterator {
+ public:
+  /**
+   * @brief Create an iterator and start to fetch the first page
+   *
+   * @param client Initialized client of the table, it has to outlive the
+   * iterator
+   * @param page_size Maximum number of key-value pairs of a page
+   */
+  FabricPageIterator(FabricClient &client, int64_t page_size);
+
+  //! Waits for a running fetch
+  ~FabricPageIterator();
+
+  FabricPageIterator(const FabricPageIterator &) = delete;
+  auto operator=(const FabricPageIterator &) -> FabricPageIterator & = delete;
+
+  /**
+   * @brief Checks if there is another page
+   *
+   * @return true if next() returns another page, false after the last page or
+   * a failed page
+   */
+  [[nodiscard]] auto has_next() const -> bool;
+
+  /**
+   * @brief Get the next page and start to fetch the following one
+   *
+   * @param page Return parameter containing the key-value pairs of the page
+   *
+   * @return Returns a status code. 0 for success and 1 for errors
+   */
+  auto next(std::map<const BYTES, BYTES> &page) -> int;
+
+ private:
+  //! Result of a fetch
+  struct Page {
+    int status = 1;
+    std::map<const BYTES, BYTES> values;
+    //! Bookmark of the following page, empty after the last page
+    std::string bookmark;
+  };
+
+  FabricClient &client_;
+  const int64_t page_size_;
+  std::future<Page> next_page_;
+  bool done_ = false;
+
+  //! Start to fetch the page of the bookmark in the background
+  void fetch(std::string bookmark);
+};
+#endif  // PAGE_ITERATOR_H
+/** @} */
@@ -0,0 +1,97 @@
+/** @defgroup group36 record_frame
+ *  @ingroup group3
+ *  @{
+ */
+#ifndef RECORD_FRAME_H
+#define RECORD_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "adapter_interface/adapter_interface.h"
+
+/**
+ * @brief Framing of the keys and values passed across the cgo boundary to
+ * the go client.
+ *
+ * A frame is a sequence of records, each one its length as 4 byte little
+ * endian integer followed by its bytes. Batches of key-value pairs alternate
+ * key and value records. The go client decodes and encodes the same format
+ * (decodeRecords and encodeRecords in trustdbleClient.go).
+ */
+class RecordFrame {
+ public:
+  //! Size of the length prefix of a record
+  static constexpr size_t LENGTH_SIZE = 4;
+
+  /**
+   * @brief Append a record to a frame
+   *
+   * @param frame Frame of records
+   * @param bytes Bytes of the record
+   */
+  static void append(std::vector<unsigned char>& frame, const BYTES& bytes);
+
+  /**
+   * @brief Read the next record of a frame
+   *
+   * @param pos Position of the record, moved behind it
+   * @param end End of the frame
+   * @param bytes Return parameter containing the bytes of the record
+   *
+   * @return true if a complete record was read, false otherwise
+   */
+  static auto read(const unsigned char*& pos, const unsigned char* end,
+                   BYTES& bytes) -> bool;
+
+  /**
+   * @brief Build the frame of a batch of key-value pairs, alternating key and
+   * value records
+   *
+   * @param batch Batch of key-value pairs
+   *
+   * @return Frame of records
+   */
+  static auto from_pairs(const std::map<const BYTES, const BYTES>& batch)
+      -> std::vector<unsigned char>;
+
+  /**
+   * @brief Build the frame of a list of keys, one record per key
+   *
+   * @param keys Keys of the frame
+   *
+   * @return Frame of records
+   */
+  static auto from_keys(const std::list<BYTES>& keys)
+      -> std::vector<unsigned char>;
+
+  /**
+   * @brief Build the frame of a list of strings, one record per string
+   *
+   * @param strings Strings of the frame, e.g. transaction ids
+   *
+   * @return Frame of records
+   */
+  static auto from_strings(const std::vector<std::string>& strings)
+      -> std::vector<unsigned char>;
+
+  /**
+   * @brief Read the key-value pairs of a frame of alternating key and value
+   * records
+   *
+   * @param data Start of the frame
+   * @param size Size of the frame in bytes
+   * @param pairs Return parameter, the pairs of the frame are added to it
+   *
+   * @return true if the frame consists of complete pairs, false otherwise;
+   * the pairs before the first incomplete one are added anyway
+   */
+  static auto to_pairs(const unsigned char* data, size_t size,
+                       std::map<const BYTES, BYTES>& pairs) -> bool;
+};
+#endif  // RECORD_FRAME_H
+/** @} */
@@ -3,6 +3,10 @@
  */
 #include "adapter_fabric/adapter_fabric.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "adapter_utils/encoding_helpers.h"
 
 /* 
@@ -77,6 +81,39 @@ auto FabricAdapter::put(std::map<const BYTES, const BYTES> &batch) -> int {
   return 1;
 }
 
+auto FabricAdapter::put_async(std::map<const BYTES, const BYTES> &batch,
+                              std::vector<std::string> &transactions) -> int {
+  if (client_.isInit()) {
+    std::string transaction_id;
+    auto error = client_.submitPut(batch, transaction_id);
+
+    if (error == 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "fabric: Put_Async, Sent transaction " << transaction_id;
+      transactions.push_back(std::move(transaction_id));
+      batch.clear();
+      return 0;
+    }
+    BOOST_LOG_TRIVIAL(debug) << "fabric: Put_Async failed!";
+
+    return 1;
+  }
+  BOOST_LOG_TRIVIAL(debug) << "fabric: FabricClient is not initialized!";
+
+  return 1;
+}
+
+auto FabricAdapter::await_puts(const std::vector<std::string> &transactions)
+    -> int {
+  if (transactions.empty()) {
+    return 0;
+  }
+  auto error = client_.awaitCommits(transactions);
+  BOOST_LOG_TRIVIAL(debug) << "fabric: Await_Puts, " << transactions.size()
+                           << " transactions, status " << error;
+  return error == 0 ? 0 : 1;
+}
+
 auto FabricAdapter::get(const BYTES &key, BYTES &result) -> int {
   if (client_.isInit()) {
     auto error = client_.get(key, result);
@@ -122,7 +159,7 @@ auto FabricAdapter::remove_batch(std::list<BYTES> &batch) -> int {
 
 auto FabricAdapter::get_all(std::map<const BYTES, BYTES> &results) -> int {
   if (client_.isInit()) {
-    auto error = client_.getAll(results);
+    auto error = client_.getAll(results, config_.scan_page_size());
 
     if (error != 0) {
       BOOST_LOG_TRIVIAL(debug) << "fabric: Get ALL failed";
@@ -151,35 +188,81 @@ auto FabricAdapter::load_table(const std::string &name,
                                const std::string &tableAddress) -> int {
   (void)tableAddress;
 
-  BOOST_LOG_TRIVIAL(debug) << "fabric: DeployContract";
-
   std::string contract_name = config_.channel_name();
+  std::string hex_table_name = string_to_hex(name);
+
+  // Init fabric client for communication with blockchain network
+  if (client_.init(config_.channel_name(), contract_name, config_.msp_id(),
+                   config_.cert_path(), config_.key_path(),
+                   config_.tls_cert_path(), config_.peer_endpoint(),
+                   config_.gateway_peer(), hex_table_name) != 0) {
+    return 1;
+  }
+
+  return deploy_contract(contract_name);
+}
 
+auto FabricAdapter::deploy_contract(const std::string &contract_name) -> int {
+  // State of the deployment of a chaincode on a channel, its mutex is held
+  // while deploying, so the shards of a table don't deploy concurrently
+  // while other chaincodes are deployed independently
+  struct Deployment {
+    std::mutex mutex;
+    bool deployed = false;
+  };
+  static std::mutex deployments_mutex;
+  static std::map<std::string, std::shared_ptr<Deployment>> deployments;
+
+  std::shared_ptr<Deployment> deployment;
+  {
+    std::lock_guard<std::mutex> lock(deployments_mutex);
+    auto &entry = deployments[config_.channel_name() + "|" + contract_name];
+    if (entry == nullptr) {
+      entry = std::make_shared<Deployment>();
+    }
+    deployment = entry;
+  }
+
+  std::lock_guard<std::mutex> lock(deployment->mutex);
+  if (deployment->deployed) {
+    return 0;
+  }
+
+  std::string version;
+  int64_t sequence = 0;
+  if (client_.committedDefinition(contract_name, version, sequence) == 0 &&
+      version == kChaincodeVersion) {
+    BOOST_LOG_TRIVIAL(debug) << "fabric: DeployContract, " << contract_name
+                             << " is already committed on channel "
+                             << config_.channel_name();
+    deployment->deployed = true;
+    return 0;
+  }
+
+  BOOST_LOG_TRIVIAL(debug) << "fabric: DeployContract";
+
+  // a new definition has to follow the sequence of the committed one, the
+  // first definition of a chaincode on a channel has sequence 1
   std::string deploy_command =
       config_.adapters_path() + "/fabric/scripts/deployContract.sh " +
       config_.channel_name() + " " + contract_name + " " +
       config_.peer_endpoint() + " " + config_.test_network_path() + " " +
-      config_.adapters_path();
+      config_.adapters_path() + " " + kChaincodeVersion + " " +
+      std::to_string(sequence + 1);
 
   if (system(deploy_command.c_str()) != 0) {
     return 1;
   }
-
-  std::string hex_table_name = string_to_hex(name);
-
-  // Init fabric client for communicationget_all with blockchain network
-  return client_.init(config_.channel_name(), contract_name, config_.msp_id(),
-                      config_.cert_path(), config_.key_path(),
-                      config_.tls_cert_path(), config_.peer_endpoint(),
-                      config_.gateway_peer(), hex_table_name);
+  deployment->deployed = true;
+  return 0;
 }
 
 auto FabricAdapter::drop_table() -> int {
   std::map<const BYTES, BYTES> results;
   if (this->get_all(results) == 0) {
     std::list<BYTES> batch;
-    for (auto iter : results) {
-      batch.push_back(std::get<0>(iter));
+    for (const auto &iter : results) {
+      batch.push_back(iter.first);
     }
     remove_batch(batch);
   }
@@ -3,142 +3,44 @@
  */
 #include "adapter_fabric/client_fabric.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <map>
 #include <string>
 #include <utility>
 
 #include "../extern/go_client/libclient.hpp"
+#include "adapter_fabric/page_iterator.h"
+#include "adapter_fabric/record_frame.h"
 
 // Helper methods
 
-/**
- * @brief Transform a map of key-value pairs into a GoString containing
- * a JSON representation of the map
- *
- * @param bytes_map a map of key-value pairs
- *
- * @return key-value pairs represented as a GoString in JSON format
- */
-static auto map_to_json_go_string(std::map<const BYTES, const BYTES>& bytes_map)
-    -> GoString {
-  nlohmann::json json_object = nlohmann::json::object();
-  for (const auto& iter : bytes_map) {
-    std::string key =
-        BcAdapter::byte_array_to_hex(iter.first.value, iter.first.size);
-    std::string value =
-        BcAdapter::byte_array_to_hex(iter.second.value, iter.second.size);
-    json_object[key] = value;
-  }
-  std::string serialized_map = json_object.dump();
-  char* serialized_map_bytes = new char[serialized_map.length()];
-  memcpy(serialized_map_bytes, serialized_map.c_str(), serialized_map.length());
-  GoString serialized_go_map = {serialized_map_bytes,
-                                (long)serialized_map.length()};
-  return serialized_go_map;
-}
-
-/**
- * @brief Transform a JSON representation of a map of key-value pairs
- * into a map
- *
- * @param serialized_map key-value pairs represented as string in JSON format
- *
- * @return a map of key-value pairs
- */
-static auto json_string_to_map(char* serialized_map)
-    -> std::map<const BYTES, BYTES> {
-  std::map<const BYTES, BYTES> bytes_map = std::map<const BYTES, BYTES>();
-  nlohmann::json json_object = nlohmann::json::parse(serialized_map);
-  for (const auto& iter : json_object.items()) {
-    // BYTES implementation leads to unecessary allocation here
-    // should BYTES be changed or should we not use the constructor here?
-    auto key_length = iter.key().length() / 2;
-    unsigned char* key_bytes = new unsigned char[key_length];
-    BcAdapter::hex_to_byte_array(iter.key(), key_bytes);
-    BYTES key = BYTES(key_bytes, iter.key().length() / 2);
-    delete[] key_bytes;
-
-    auto value_length = iter.value().get<std::string>().length() / 2;
-    unsigned char* value_bytes = new unsigned char[value_length];
-    BcAdapter::hex_to_byte_array(iter.value().get<std::string>(), value_bytes);
-    BYTES value = BYTES(value_bytes, value_length);
-    delete[] value_bytes;
-    bytes_map[key] = value;
-  }
-  return bytes_map;
-}
+//! Functions of the chaincode
+static const std::string kFunctionPut = "put";
+static const std::string kFunctionGet = "get";
+static const std::string kFunctionDelete = "delete";
 
 /**
- * @brief Tranform a list of byte arrays into a GoString containing a JSON
- * representation of the list
+ * @brief Wrap a frame of records into a GoSlice without copying it
  *
- * @param bytes_list a list of byte arrays
+ * @param frame Frame of records
  *
- *  @return list of byte arrays as a GoString in JSON format
+ * @return GoSlice referring to the frame
  */
-static auto list_to_json_go_string(std::list<BYTES>& bytes_list) -> GoString {
-  nlohmann::json json_array = nlohmann::json::array();
-  for (const auto& bytes : bytes_list) {
-    std::string hex = BcAdapter::byte_array_to_hex(bytes.value, bytes.size);
-    json_array.push_back(hex);
-  }
-  std::string serialized_list = json_array.dump();
-  char* serialized_list_bytes = new char[serialized_list.length()];
-  memcpy(serialized_list_bytes, serialized_list.c_str(),
-         serialized_list.length());
-  GoString serialized_go_list = {serialized_list_bytes,
-                                 (long)serialized_list.length()};
-  return serialized_go_list;
-}
-
-/**
- * @brief Return a GoString containing a JSON representation of an empty
- * object
- *
- * @return an empty object represented as a GoString in JSON format
- */
-static auto empty_object_json_go_string() -> GoString {
-  std::string empty_json_object = "{}";
-  char* serialized_map_bytes = new char[empty_json_object.length()];
-  memcpy(serialized_map_bytes, empty_json_object.c_str(),
-         empty_json_object.length());
-  GoString go_empty_json_object = {serialized_map_bytes,
-                                   (long)empty_json_object.length()};
-  return go_empty_json_object;
-}
-
-/**
- * @brief Transform bytes into a GoString containing a hex encoded
- * representation of the byte array
- *
- * @param in an array of bytes in a BYTES object
- *
- * @return GoString containing the bytes encoded as hex
- */
-static auto bytes_to_go_string(const BYTES& in) -> GoString {
-  std::string hex_representation =
-      BcAdapter::byte_array_to_hex(in.value, in.size);
-  char* hex_representation_bytes = new char[hex_representation.length()];
-  memcpy(hex_representation_bytes, hex_representation.c_str(),
-         hex_representation.length());
-  GoString go_hex_representation = {hex_representation_bytes,
-                                    (long)hex_representation.length()};
-  return go_hex_representation;
+static auto frame_to_go_slice(std::vector<unsigned char>& frame) -> GoSlice {
+  return GoSlice{frame.data(), static_cast<GoInt>(frame.size()),
+                 static_cast<GoInt>(frame.capacity())};
 }
 
 /**
- * @brief Transform a string into a GoString
+ * @brief Refer to a string as GoString without copying it
  *
  * @param in a C++ string
  *
  * @return a GoString
  */
 static auto string_to_go_string(const std::string& in) -> GoString {
-  char* string_bytes = new char[in.length()];
-  memcpy(string_bytes, in.c_str(), in.length());
-  GoString go_string = {string_bytes, (long)in.length()};
-  return go_string;
+  return GoString{in.c_str(), static_cast<ptrdiff_t>(in.length())};
 }
 
 // Constructor
@@ -159,122 +61,133 @@ auto FabricClient::init(std::string channel_name, std::string contract_name,
     }
   }
 
-  this->channel_name_ = std::move(channel_name);
-  this->contract_name_ = std::move(contract_name);
-  this->msp_id_ = std::move(msp_id);
-  this->cert_path_ = std::move(cert_path);
-  this->key_path_ = std::move(key_path);
-  this->tls_cert_path_ = std::move(tls_cert_path);
-  this->peer_endpoint_ = std::move(peer_endpoint);
-  this->gateway_peer_ = std::move(gateway_peer);
   this->table_name_ = std::move(table_name);
-  GoString go_msp_id = {this->msp_id_.c_str(), (long)this->msp_id_.length()};
-  GoString go_cert_path = {this->cert_path_.c_str(),
-                           (long)this->cert_path_.length()};
-  GoString go_key_path = {this->key_path_.c_str(),
-                          (long)this->key_path_.length()};
-  GoString go_tls_cert_path = {this->tls_cert_path_.c_str(),
-                               (long)this->tls_cert_path_.length()};
-  GoString go_peer_endpoint = {this->peer_endpoint_.c_str(),
-                               (long)this->peer_endpoint_.length()};
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_channel_name = {this->channel_name_.c_str(),
-                              (long)this->channel_name_.length()};
-  GoString go_contract_name = {this->contract_name_.c_str(),
-                               (long)this->contract_name_.length()};
-
-  int status_code =
+  GoString go_msp_id = {msp_id.c_str(), (long)msp_id.length()};
+  GoString go_cert_path = {cert_path.c_str(), (long)cert_path.length()};
+  GoString go_key_path = {key_path.c_str(), (long)key_path.length()};
+  GoString go_tls_cert_path = {tls_cert_path.c_str(),
+                               (long)tls_cert_path.length()};
+  GoString go_peer_endpoint = {peer_endpoint.c_str(),
+                               (long)peer_endpoint.length()};
+  GoString go_gateway_peer = {gateway_peer.c_str(),
+                              (long)gateway_peer.length()};
+  GoString go_channel_name = {channel_name.c_str(),
+                              (long)channel_name.length()};
+  GoString go_contract_name = {contract_name.c_str(),
+                               (long)contract_name.length()};
+
+  // the gateway connection is shared with all clients of the same peer and
+  // identity, the client only keeps the handle of its contract
+  Init_return result =
       Init(go_channel_name, go_contract_name, go_msp_id, go_cert_path,
            go_key_path, go_tls_cert_path, go_peer_endpoint, go_gateway_peer);
-
+  if (result.r1 != 0) {
+    return 1;
+  }
+  handle_ = result.r0;
   isInitializied_ = true;
 
-  return status_code;
+  return 0;
 }
 
 auto FabricClient::put(std::map<const BYTES, const BYTES>& batch) -> int {
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_table_name = {this->table_name_.c_str(),
-                            (long)this->table_name_.length()};
-  GoString key_value_pairs = map_to_json_go_string(batch);
-  GoString function = string_to_go_string("put");
-  int status_code =
-      Write(key_value_pairs, function, go_table_name, go_gateway_peer);
-  delete[] key_value_pairs.p;
-  delete[] function.p;
-  return status_code;
+  std::vector<unsigned char> frame = RecordFrame::from_pairs(batch);
+  return Write(frame_to_go_slice(frame), string_to_go_string(kFunctionPut),
+               string_to_go_string(table_name_), handle_);
 }
 
-auto FabricClient::get(const BYTES& key, BYTES& value) -> int {
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_table_name = {this->table_name_.c_str(),
-                            (long)this->table_name_.length()};
-  GoString go_key = bytes_to_go_string(key);
-  GoString function = string_to_go_string("get");
-  Read_return go_result =
-      Read(go_key, function, go_table_name, go_gateway_peer);
-  delete[] go_key.p;
-  delete[] function.p;
-  if (go_result.r2 != 0) {
+auto FabricClient::submitPut(std::map<const BYTES, const BYTES>& batch,
+                             std::string& transaction_id) -> int {
+  std::vector<unsigned char> frame = RecordFrame::from_pairs(batch);
+  SubmitAsync_return result =
+      SubmitAsync(frame_to_go_slice(frame), string_to_go_string(kFunctionPut),
+                  string_to_go_string(table_name_), handle_);
+  if (result.r1 != 0) {
     return 1;
   }
-  unsigned char* value_bytes = new unsigned char[go_result.r1 / 2];
-  BcAdapter::hex_to_byte_array(go_result.r0, value_bytes);
-  value = BYTES(value_bytes, go_result.r1 / 2);
+  transaction_id = result.r0;
+  free(result.r0);
   return 0;
 }
 
-auto FabricClient::getAll(std::map<const BYTES, BYTES>& values) -> int {
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_table_name = {this->table_name_.c_str(),
-                            (long)this->table_name_.length()};
-  GoString empty_json_object = empty_object_json_go_string();
-  GoString function = string_to_go_string("getAll");
-  Read_return result =
-      Read(empty_json_object, function, go_table_name, go_gateway_peer);
-  delete[] empty_json_object.p;
-  delete[] function.p;
+auto FabricClient::awaitCommits(const std::vector<std::string>& transaction_ids)
+    -> int {
+  std::vector<unsigned char> frame = RecordFrame::from_strings(transaction_ids);
+  return AwaitCommits(frame_to_go_slice(frame));
+}
+
+auto FabricClient::get(const BYTES& key, BYTES& value) -> int {
+  GoSlice go_key = {key.value, static_cast<GoInt>(key.size),
+                    static_cast<GoInt>(key.size)};
+  Read_return result = Read(go_key, string_to_go_string(kFunctionGet),
+                            string_to_go_string(table_name_), handle_);
   if (result.r2 != 0) {
     return 1;
   }
-  values = json_string_to_map(result.r0);
+  value = BYTES(static_cast<unsigned char*>(result.r0),
+                static_cast<size_t>(result.r1));
+  free(result.r0);
   return 0;
 }
 
-auto FabricClient::remove(std::list<BYTES>& batch) -> int {
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_table_name = {this->table_name_.c_str(),
-                            (long)this->table_name_.length()};
+auto FabricClient::getAll(std::map<const BYTES, BYTES>& values,
+                          int64_t page_size) -> int {
+  FabricPageIterator pages(*this, page_size);
+  while (pages.has_next()) {
+    std::map<const BYTES, BYTES> page;
+    if (pages.next(page) != 0) {
+      return 1;
+    }
+    values.merge(page);
+  }
+  return 0;
+}
 
-  GoString go_keys = list_to_json_go_string(batch);
+auto FabricClient::getPage(int64_t page_size, const std::string& bookmark,
+                           std::map<const BYTES, BYTES>& values,
+                           std::string& next_bookmark) -> int {
+  ReadPage_return result =
+      ReadPage(string_to_go_string(table_name_), page_size,
+               string_to_go_string(bookmark), handle_);
+  if (result.r3 != 0) {
+    return 1;
+  }
 
-  GoString function = string_to_go_string("delete");
-  int status_code = Write(go_keys, function, go_table_name, go_gateway_peer);
-  delete[] go_keys.p;
-  delete[] function.p;
-  return status_code;
+  const int status =
+      RecordFrame::to_pairs(static_cast<const unsigned char*>(result.r0),
+                            static_cast<size_t>(result.r1), values)
+          ? 0
+          : 1;
+  next_bookmark = result.r2;
+  free(result.r0);
+  free(result.r2);
+  return status;
+}
+
+auto FabricClient::remove(std::list<BYTES>& batch) -> int {
+  std::vector<unsigned char> frame = RecordFrame::from_keys(batch);
+  return Write(frame_to_go_slice(frame), string_to_go_string(kFunctionDelete),
+               string_to_go_string(table_name_), handle_);
+}
+
+auto FabricClient::committedDefinition(const std::string& contract_name,
+                                       std::string& version,
+                                       int64_t& sequence) -> int {
+  Committed_return result =
+      Committed(handle_, string_to_go_string(contract_name));
+  if (result.r2 != 0) {
+    return 1;
+  }
+  version = result.r0;
+  sequence = result.r1;
+  free(result.r0);
+  return 0;
 }
 
 auto FabricClient::close() -> int {
   isInitializied_ = false;
-  GoString go_gateway_peer = {this->gateway_peer_.c_str(),
-                              (long)this->gateway_peer_.length()};
-  GoString go_contract_name = {this->contract_name_.c_str(),
-                               (long)this->contract_name_.length()};
-  int status_code = Close(go_contract_name, go_gateway_peer);
-  this->channel_name_ = "";
-  this->contract_name_ = "";
-  this->msp_id_ = "";
-  this->cert_path_ = "";
-  this->key_path_ = "";
-  this->tls_cert_path_ = "";
-  this->peer_endpoint_ = "";
-  this->gateway_peer_ = "";
+  int status_code = Close(handle_);
+  this->handle_ = 0;
   this->table_name_ = "";
   return status_code;
 }
@@ -0,0 +1,47 @@
+/*! \addtogroup group35
+ *  @{
+ */
+#include "adapter_fabric/page_iterator.h"
+
+#include <utility>
+
+FabricPageIterator::FabricPageIterator(FabricClient &client, int64_t page_size)
+    : client_(client), page_size_(page_size) {
+  fetch("");
+}
+
+FabricPageIterator::~FabricPageIterator() {
+  if (next_page_.valid()) {
+    next_page_.wait();
+  }
+}
+
+auto FabricPageIterator::has_next() const -> bool { return !done_; }
+
+auto FabricPageIterator::next(std::map<const BYTES, BYTES> &page) -> int {
+  if (done_) {
+    return 1;
+  }
+  Page fetched = next_page_.get();
+  if (fetched.status != 0) {
+    done_ = true;
+    return 1;
+  }
+  if (fetched.bookmark.empty()) {
+    done_ = true;
+  } else {
+    fetch(std::move(fetched.bookmark));
+  }
+  page.swap(fetched.values);
+  return 0;
+}
+
+void FabricPageIterator::fetch(std::string bookmark) {
+  next_page_ = std::async(std::launch::async, [this, bookmark] {
+    Page page;
+    page.status =
+        client_.getPage(page_size_, bookmark, page.values, page.bookmark);
+    return page;
+  });
+}
+/** @} */
@@ -0,0 +1,94 @@
+/*! \addtogroup group36
+ *  @{
+ */
+#include "adapter_fabric/record_frame.h"
+
+#include <utility>
+
+constexpr size_t RecordFrame::LENGTH_SIZE;
+
+void RecordFrame::append(std::vector<unsigned char>& frame,
+                         const BYTES& bytes) {
+  const auto length = static_cast<uint32_t>(bytes.size);
+  for (size_t i = 0; i < LENGTH_SIZE; i++) {
+    frame.push_back(static_cast<unsigned char>(length >> (8 * i)));
+  }
+  frame.insert(frame.end(), bytes.value, bytes.value + bytes.size);
+}
+
+auto RecordFrame::read(const unsigned char*& pos, const unsigned char* end,
+                       BYTES& bytes) -> bool {
+  if (static_cast<size_t>(end - pos) < LENGTH_SIZE) {
+    return false;
+  }
+  uint32_t length = 0;
+  for (size_t i = 0; i < LENGTH_SIZE; i++) {
+    length |= static_cast<uint32_t>(pos[i]) << (8 * i);
+  }
+  if (static_cast<size_t>(end - pos) - LENGTH_SIZE < length) {
+    return false;
+  }
+  pos += LENGTH_SIZE;
+  bytes = BYTES(pos, length);
+  pos += length;
+  return true;
+}
+
+auto RecordFrame::from_pairs(const std::map<const BYTES, const BYTES>& batch)
+    -> std::vector<unsigned char> {
+  size_t frame_size = 0;
+  for (const auto& pair : batch) {
+    frame_size += 2 * LENGTH_SIZE + pair.first.size + pair.second.size;
+  }
+  std::vector<unsigned char> frame;
+  frame.reserve(frame_size);
+  for (const auto& pair : batch) {
+    append(frame, pair.first);
+    append(frame, pair.second);
+  }
+  return frame;
+}
+
+auto RecordFrame::from_keys(const std::list<BYTES>& keys)
+    -> std::vector<unsigned char> {
+  size_t frame_size = 0;
+  for (const auto& key : keys) {
+    frame_size += LENGTH_SIZE + key.size;
+  }
+  std::vector<unsigned char> frame;
+  frame.reserve(frame_size);
+  for (const auto& key : keys) {
+    append(frame, key);
+  }
+  return frame;
+}
+
+auto RecordFrame::from_strings(const std::vector<std::string>& strings)
+    -> std::vector<unsigned char> {
+  size_t frame_size = 0;
+  for (const auto& string : strings) {
+    frame_size += LENGTH_SIZE + string.size();
+  }
+  std::vector<unsigned char> frame;
+  frame.reserve(frame_size);
+  for (const auto& string : strings) {
+    append(frame, BYTES(string));
+  }
+  return frame;
+}
+
+auto RecordFrame::to_pairs(const unsigned char* data, size_t size,
+                           std::map<const BYTES, BYTES>& pairs) -> bool {
+  const unsigned char* pos = data;
+  const unsigned char* end = data + size;
+  while (pos < end) {
+    BYTES key;
+    BYTES value;
+    if (!read(pos, end, key) || !read(pos, end, value)) {
+      return false;
+    }
+    pairs.emplace(std::move(key), std::move(value));
+  }
+  return true;
+}
+/** @} */
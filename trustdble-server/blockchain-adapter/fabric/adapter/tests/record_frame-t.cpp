@@ -0,0 +1,112 @@
+/** @defgroup group37 record_frame_test
+ *  @ingroup group3
+ *  @{
+ */
+
+/**
+ * @file
+ * @brief This file contains tests for the framing of keys and values passed
+ * to the go client, which don't require a Fabric network.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "adapter_fabric/record_frame.h"
+
+//! Bytes of a string, including zero bytes
+static auto to_vector(const std::string &bytes) -> std::vector<unsigned char> {
+  return std::vector<unsigned char>(bytes.begin(), bytes.end());
+}
+
+TEST(RecordFrameTests, emptyFrame) {
+  EXPECT_TRUE(RecordFrame::from_pairs({}).empty());
+  EXPECT_TRUE(RecordFrame::from_keys({}).empty());
+  EXPECT_TRUE(RecordFrame::from_strings({}).empty());
+
+  std::map<const BYTES, BYTES> pairs;
+  EXPECT_TRUE(RecordFrame::to_pairs(nullptr, 0, pairs));
+  EXPECT_TRUE(pairs.empty());
+}
+
+TEST(RecordFrameTests, recordLayout) {
+  // the length is a 4 byte little endian integer
+  std::vector<unsigned char> frame;
+  RecordFrame::append(frame, BYTES(std::string(258, 'x')));
+  ASSERT_EQ(frame.size(), RecordFrame::LENGTH_SIZE + 258);
+  EXPECT_EQ(std::vector<unsigned char>(frame.begin(), frame.begin() + 4),
+            to_vector(std::string("\x02\x01\x00\x00", 4)));
+
+  EXPECT_EQ(RecordFrame::from_strings({"tx1", ""}),
+            to_vector(std::string("\x03\x00\x00\x00tx1\x00\x00\x00\x00", 11)));
+}
+
+TEST(RecordFrameTests, roundTrip) {
+  std::map<const BYTES, const BYTES> batch;
+  batch.emplace(BYTES("key1"), BYTES("value1"));
+  // zero-length value and binary bytes
+  batch.emplace(BYTES("key2"), BYTES(""));
+  batch.emplace(BYTES(std::string("k\0y", 3)),
+                BYTES(std::string("\0\xff\x01", 3)));
+  std::vector<unsigned char> frame = RecordFrame::from_pairs(batch);
+  EXPECT_EQ(frame.size(), 6 * RecordFrame::LENGTH_SIZE + 4 + 6 + 4 + 3 + 3);
+
+  std::map<const BYTES, BYTES> pairs;
+  ASSERT_TRUE(RecordFrame::to_pairs(frame.data(), frame.size(), pairs));
+  ASSERT_EQ(pairs.size(), batch.size());
+  for (const auto &pair : batch) {
+    auto it = pairs.find(pair.first);
+    ASSERT_NE(it, pairs.end());
+    EXPECT_EQ(it->second, pair.second);
+  }
+
+  // keys are read one record at a time
+  std::list<BYTES> keys = {BYTES("a"), BYTES(""), BYTES("ccc")};
+  frame = RecordFrame::from_keys(keys);
+  const unsigned char *pos = frame.data();
+  const unsigned char *end = frame.data() + frame.size();
+  for (const auto &key : keys) {
+    BYTES read;
+    ASSERT_TRUE(RecordFrame::read(pos, end, read));
+    EXPECT_EQ(read, key);
+  }
+  EXPECT_EQ(pos, end);
+}
+
+TEST(RecordFrameTests, truncatedLengthPrefix) {
+  std::vector<unsigned char> frame = to_vector(std::string("\x01\x00\x00", 3));
+  const unsigned char *pos = frame.data();
+  BYTES bytes;
+  EXPECT_FALSE(RecordFrame::read(pos, frame.data() + frame.size(), bytes));
+  EXPECT_EQ(pos, frame.data());
+
+  // a complete pair followed by a partial length
+  std::map<const BYTES, const BYTES> batch;
+  batch.emplace(BYTES("key"), BYTES("value"));
+  frame = RecordFrame::from_pairs(batch);
+  frame.push_back(0x01);
+  std::map<const BYTES, BYTES> pairs;
+  EXPECT_FALSE(RecordFrame::to_pairs(frame.data(), frame.size(), pairs));
+  EXPECT_EQ(pairs.size(), 1U);
+}
+
+TEST(RecordFrameTests, truncatedRecord) {
+  // the length exceeds the remaining bytes
+  std::vector<unsigned char> frame =
+      to_vector(std::string("\x05\x00\x00\x00" "abc", 7));
+  const unsigned char *pos = frame.data();
+  BYTES bytes;
+  EXPECT_FALSE(RecordFrame::read(pos, frame.data() + frame.size(), bytes));
+  EXPECT_EQ(pos, frame.data());
+
+  // a key without its value
+  std::map<const BYTES, BYTES> pairs;
+  frame = RecordFrame::from_keys({BYTES("key")});
+  EXPECT_FALSE(RecordFrame::to_pairs(frame.data(), frame.size(), pairs));
+  EXPECT_TRUE(pairs.empty());
+
+  // a length beyond 2^31 must not overflow the bounds check
+  frame = to_vector(std::string("\xff\xff\xff\xff" "abc", 7));
+  pos = frame.data();
+  EXPECT_FALSE(RecordFrame::read(pos, frame.data() + frame.size(), bytes));
+}
+/** @} */
@@ -11,9 +11,11 @@ import org.hyperledger.fabric.shim.ChaincodeException;
 import org.hyperledger.fabric.shim.ChaincodeStub;
 import org.hyperledger.fabric.shim.ledger.KeyValue;
 import org.hyperledger.fabric.shim.ledger.QueryResultsIterator;
+import org.hyperledger.fabric.shim.ledger.QueryResultsIteratorWithMetadata;
 
 import java.util.Map;
 import java.util.HashMap;
+import java.util.LinkedHashMap;
 import java.util.List;
 import java.util.logging.Logger;
 
@@ -135,6 +137,53 @@ public class TrustDBleContract implements ContractInterface {
 		return gson.toJson(results);
 	}
 
+	/**
+	 * Retrieves a page of the key-value pairs of a table from the ledger. The
+	 * bookmark of the result continues the range query with the next page.
+	 *
+	 * @param ctx      the transaction context
+	 * @param pageSize maximum number of pairs of the page
+	 * @param bookmark bookmark returned with the previous page, empty for the
+	 *                 first page
+	 * @return json object with the bookmark of the next page and the pairs
+	 */
+	@Transaction(intent = Transaction.TYPE.EVALUATE)
+	public String getPage(final Context ctx, final String table, final int pageSize, final String bookmark) {
+		ChaincodeStub stub = ctx.getStub();
+
+		try {
+			Hex.decodeHex(table);
+		} catch (DecoderException e) {
+			throw new ChaincodeException("Ilegal table name: table name must be hex encoded");
+		}
+
+		if (pageSize <= 0) {
+			throw new ChaincodeException("Ilegal page size: page size must be positive");
+		}
+
+		Map<String, String> pairs = new LinkedHashMap<String, String>();
+
+		String startKey = table + DELIMITER;
+		String endKey = table + RANGE_END_DELIMITER;
+		QueryResultsIteratorWithMetadata<KeyValue> resultsIterator = stub.getStateByRangeWithPagination(startKey,
+				endKey, pageSize, bookmark);
+
+		for (KeyValue result : resultsIterator) {
+			// same encoding as getAll
+			int delimiterIndex = result.getKey().indexOf(DELIMITER);
+			String key = result.getKey().substring(delimiterIndex + 1);
+			pairs.put(key, Hex.encodeHexString(result.getValue()));
+		}
+
+		Map<String, Object> page = new HashMap<String, Object>();
+		// a page with less pairs than requested is the last one
+		page.put("bookmark", pairs.size() < pageSize ? "" : resultsIterator.getMetadata().getBookmark());
+		page.put("pairs", pairs);
+
+		Gson gson = new Gson();
+		return gson.toJson(page);
+	}
+
 	/**
 	 * Deletes a key-value pair on the ledger.
 	 *
@@ -5,10 +5,12 @@ CC_NAME=$2
 PEER_ADDRESS=$3
 TESTNETWORK_PATH=$4
 TRUSTDBLE_ADAPTER_PATH=$5
+CC_VERSION=${6:-"1.0"}
+CC_SEQUENCE=${7:-"1"}
 
 cp $TRUSTDBLE_ADAPTER_PATH/fabric/scripts/deployTDB.sh $TESTNETWORK_PATH/deployTrustDBle.sh
 cd $TESTNETWORK_PATH
 
-./deployTrustDBle.sh $CHANNEL_NAME $CC_NAME $TRUSTDBLE_ADAPTER_PATH/fabric/contract $PEER_ADDRESS
+./deployTrustDBle.sh $CHANNEL_NAME $CC_NAME $TRUSTDBLE_ADAPTER_PATH/fabric/contract $PEER_ADDRESS NA $CC_VERSION $CC_SEQUENCE
 
 rm $TESTNETWORK_PATH/deployTrustDBle.sh
\ No newline at end of file
@@ -6,7 +6,12 @@
 #define ADAPTER_INTERFACE_H
 
 #include <boost/property_tree/ptree.hpp>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -15,8 +20,16 @@ namespace pt = boost::property_tree;
 /**
  * @brief Struct that is representing a pair of value in bytes and it's size.
  * It is used to send key/value with it's size to adapter methods
+ *
+ * @details Values of up to INLINE_SIZE bytes (e.g. SHA-256 keys) are stored
+ * inline without a heap allocation. BYTES objects can be moved cheaply, and
+ * view() creates a BYTES object that borrows memory owned by someone else.
+ * Copies of a view always own their bytes.
  */
 struct BYTES {
+  //! Number of bytes that are stored without a heap allocation
+  static constexpr size_t INLINE_SIZE = 32;
+
   //! The array of bytes stored in the BYTES object
   unsigned char *value;
   //! The array's length
@@ -28,17 +41,25 @@ struct BYTES {
    * @param send_value The array of bytes as an unsigned char array
    * @param send_size The arrays length
    */
-  BYTES(unsigned char *send_value, size_t send_size) {
-    value = new unsigned char[send_size];
-    memcpy(value, send_value, send_size);
-    size = send_size;
+  BYTES(const unsigned char *send_value, size_t send_size) {
+    allocate(send_size);
+    if (send_size > 0) {
+      memcpy(value, send_value, send_size);
+    }
   }
+  /**
+   * @brief Constructs a BYTES object with an uninitialized array of the given
+   * length, e.g. to be filled by a decoder. The length may be reduced
+   * afterwards by setting size.
+   *
+   * @param send_size The arrays length
+   */
+  explicit BYTES(size_t send_size) { allocate(send_size); }
   /**
    * @brief Constructs a BYTES object of only one byte
    */
   BYTES() {
-    value = new unsigned char[1];
-    size = 1;
+    allocate(1);
     value[0] = '\0';
   }
   /**
@@ -47,14 +68,9 @@ struct BYTES {
    *
    * @param send_value The string to be stored in the BYTES object
    */
-  BYTES(const std::string &send_value) {
-    size = send_value.size();
-    value = new unsigned char[size];
-    memcpy(value,
-           reinterpret_cast<unsigned char *>(
-               const_cast<char *>(send_value.c_str())),
-           size);
-  }
+  BYTES(const std::string &send_value)
+      : BYTES(reinterpret_cast<const unsigned char *>(send_value.data()),
+              send_value.size()) {}
   /**
    * @brief Copy constructor for BYTES objects. Initializes a new BYTES
    * object with the bytes of the other object by copying the underlying
@@ -62,13 +78,17 @@ struct BYTES {
    *
    * @param that The BYTES object of which bytes are copied
    */
-  BYTES(const BYTES &that) {
-    size = that.size;
-    value = new unsigned char[size];
-    memcpy(value, that.value, size);
-  }
+  BYTES(const BYTES &that) : BYTES(that.value, that.size) {}
+  /**
+   * @brief Move constructor for BYTES objects. Takes over the heap array or
+   * borrowed memory of the other object; inline bytes are copied. The other
+   * object is left empty (size 0).
+   *
+   * @param that The BYTES object whose bytes are taken over
+   */
+  BYTES(BYTES &&that) noexcept { take(that); }
   //! Destructor
-  ~BYTES() { delete[] value; }
+  ~BYTES() { release(); }
 
   /**
    * @brief Assignment operator for BYTES objects. Fills the object that's being
@@ -83,13 +103,81 @@ struct BYTES {
     if (this == &that) {
       return *this;
     }
-    size = that.size;
-    unsigned char *local_value = new unsigned char[size];
-    memcpy(local_value, that.value, size);
-    delete[] value;
-    value = local_value;
+    BYTES copy(that);
+    release();
+    take(copy);
+    return *this;
+  }
+  /**
+   * @brief Move assignment operator for BYTES objects, see move constructor
+   *
+   * @param that The BYTES object whose bytes are taken over
+   *
+   * @return The object that's being assigned to
+   */
+  auto operator=(BYTES &&that) noexcept -> BYTES & {
+    if (this != &that) {
+      release();
+      take(that);
+    }
     return *this;
   }
+
+  /**
+   * @brief Creates a BYTES object that borrows an array of bytes without
+   * copying it. The array has to outlive the view and all objects it is
+   * moved to.
+   *
+   * @param data The array of bytes as an unsigned char array
+   * @param length The arrays length
+   *
+   * @return Non-owning BYTES object
+   */
+  static auto view(const unsigned char *data, size_t length) -> BYTES {
+    BYTES bytes(static_cast<size_t>(0));
+    bytes.value = const_cast<unsigned char *>(data);
+    bytes.size = length;
+    return bytes;
+  }
+
+  /**
+   * @brief Checks if the BYTES object borrows its array (see view())
+   *
+   * @return true if the object doesn't own its bytes
+   */
+  auto is_view() const -> bool { return value != inline_ && !heap_; }
+
+ private:
+  //! Inline storage for small arrays
+  unsigned char inline_[INLINE_SIZE];
+  //! True if value was allocated on the heap and is owned by this object
+  bool heap_{false};
+
+  void allocate(size_t length) {
+    size = length;
+    heap_ = length > INLINE_SIZE;
+    value = heap_ ? new unsigned char[length] : inline_;
+  }
+
+  void release() {
+    if (heap_) {
+      delete[] value;
+    }
+  }
+
+  void take(BYTES &that) {
+    size = that.size;
+    heap_ = that.heap_;
+    if (that.value == that.inline_) {
+      memcpy(inline_, that.inline_, size);
+      value = inline_;
+    } else {
+      value = that.value;
+    }
+    that.heap_ = false;
+    that.value = that.inline_;
+    that.size = 0;
+  }
 };
 
 /**
@@ -103,16 +191,8 @@ struct BYTES {
  * @return a bool indicating if the objects are equal
  */
 inline auto operator==(const BYTES &lhs, const BYTES &rhs) -> bool {
-  bool equal = lhs.size == rhs.size;
-  if (equal) {
-    for (size_t i = 0; i < lhs.size; i++) {
-      equal = lhs.value[i] == rhs.value[i];
-      if (!equal) {
-        return equal;
-      }
-    }
-  }
-  return equal;
+  return lhs.size == rhs.size &&
+         (lhs.size == 0 || memcmp(lhs.value, rhs.value, lhs.size) == 0);
 }
 
 /**
@@ -128,23 +208,33 @@ inline auto operator==(const BYTES &lhs, const BYTES &rhs) -> bool {
  * @return a bool indicating if the object on the left is smaller
  */
 inline auto operator<(const BYTES &lhs, const BYTES &rhs) -> bool {
-  if (lhs.size < rhs.size) {
-    return true;
-  }
-  if (lhs.size == rhs.size) {
-    for (size_t i = 0; i < lhs.size; i++) {
-      if (lhs.value[i] < rhs.value[i]) {
-        return true;
-      }
-      if (lhs.value[i] > rhs.value[i]) {
-        return false;
-      }
-    }
-    return false;
+  if (lhs.size != rhs.size) {
+    return lhs.size < rhs.size;
   }
-  return false;
+  return lhs.size > 0 && memcmp(lhs.value, rhs.value, lhs.size) < 0;
 }
 
+/**
+ * @brief Position of a table read. It is returned by BcAdapter::get_version()
+ * and passed on to get_all_at() and get_changes() by the caller, since an
+ * adapter is shared by concurrent connections and can't keep the state of a
+ * read itself.
+ */
+struct READ_TOKEN {
+  //! Adapter-specific progress of an interrupted BcAdapter::get_all_at()
+  struct PROGRESS {
+    virtual ~PROGRESS() = default;
+  };
+
+  //! Version of the table (see BcAdapter::get_version())
+  uint64_t version = 0;
+  //! Adapter-specific position the version was read at, e.g. a block number;
+  //! 0 to read the latest state
+  uint64_t position = 0;
+  //! Progress of an interrupted get_all_at(), null if there is none
+  std::unique_ptr<PROGRESS> progress;
+};
+
 /**
  * @brief Interface definition to be used by storage engine to communicate with
  * concrete blockchain technology adapter, like Ethereum, Fabric, ...
@@ -193,6 +283,40 @@ class BcAdapter {
    */
   virtual auto put(std::map<const BYTES, const BYTES> &batch) -> int = 0;
 
+  /**
+   * @brief Send a batch of key-value pairs to the blockchain without waiting
+   * until it is committed, e.g. so the batches of several shards are ordered
+   * together. The caller passes the returned transactions to await_puts();
+   * reads and removes may be ordered before the batch until then. By default
+   * the batch is put synchronously and no transaction is returned.
+   *
+   * @param batch Batch including multiple key-value pairs; sent key-value
+   * pairs are removed from the batch
+   * @param transactions Transactions of the sent batch are appended here
+   *
+   * @return status code (0 on success, 1 on failure)
+   */
+  virtual auto put_async(std::map<const BYTES, const BYTES> &batch,
+                         std::vector<std::string> &transactions) -> int {
+    (void)transactions;
+    return put(batch);
+  }
+
+  /**
+   * @brief Wait until batches sent with put_async() are committed. The adapter
+   * is shared by concurrent connections, so each caller waits only for the
+   * transactions it sent.
+   *
+   * @param transactions Transactions returned by put_async()
+   *
+   * @return status code (0 if all batches are committed, 1 on failure)
+   */
+  virtual auto await_puts(const std::vector<std::string> &transactions)
+      -> int {
+    (void)transactions;
+    return 0;
+  }
+
   /**
    * @brief Get a value of a key-value pair from the blockchain
    *
@@ -212,6 +336,23 @@ class BcAdapter {
    */
   virtual auto get_all(std::map<const BYTES, BYTES> &results) -> int = 0;
 
+  /**
+   * @brief Gets all key-value pairs from the blockchain as of the position of
+   * a token returned by get_version(). After a failure results keep the pairs
+   * read so far and an adapter may store its progress in the token, so calling
+   * again with both continues the scan. By default the latest state is read.
+   *
+   * @param results Reference of a vector of tuples to store read pairs
+   * @param token Token of the preceding get_version()
+   *
+   * @return status code (0 on success, 1 on failure)
+   */
+  virtual auto get_all_at(std::map<const BYTES, BYTES> &results,
+                          READ_TOKEN &token) -> int {
+    (void)token;
+    return get_all(results);
+  }
+
   /**
    * @brief Remove a key value pair from the blockchain
    *
@@ -249,6 +390,45 @@ class BcAdapter {
    */
   virtual auto drop_table() -> int = 0;
 
+  /**
+   * @brief Get the current version of the table. The version changes whenever
+   * the table is modified, e.g. the latest block number of the blockchain. It
+   * is used by the storage engine to check if cached rows are still valid.
+   * An adapter may set the position of the token, so get_all_at() and
+   * get_changes() with the token read the table as of the returned version.
+   *
+   * @param token Token to store the version in
+   * @return int returns 0 on success, 1 if the adapter does not support
+   * versions
+   */
+  virtual auto get_version(READ_TOKEN &token) -> int {
+    (void)token;
+    return 1;
+  }
+
+  /**
+   * @brief Get the changes of the table after a version up to the version of a
+   * token returned by get_version(), e.g. to bring cached rows up to date
+   * without reading the whole table with get_all(). Each changed key is
+   * reported once with its latest state.
+   *
+   * @param since Version of the rows that should be updated
+   * @param token Token of the preceding get_version()
+   * @param puts Reference to store the written keys with their latest values
+   * @param removes Reference to store the removed keys
+   * @return int returns 0 on success, 1 on failure or if the adapter does not
+   * support changes, then the table has to be read with get_all()
+   */
+  virtual auto get_changes(uint64_t since, const READ_TOKEN &token,
+                           std::map<const BYTES, BYTES> &puts,
+                           std::vector<BYTES> &removes) -> int {
+    (void)since;
+    (void)token;
+    (void)puts;
+    (void)removes;
+    return 1;
+  }
+
   /**
    * @brief Produces a hex encoded representation of an array of bytes
    *
@@ -165,4 +165,4 @@ TEST_P(AdapterInterfaceTest /*unused*/, TableScanAfterDrop /*unused*/) {
       << "\nTableScanAfterDrop: \" GET_ALL, Failed to open File \" expect!! \n"
       << std::endl;
 }
-/** @} */
\ No newline at end of file
+/** @} */
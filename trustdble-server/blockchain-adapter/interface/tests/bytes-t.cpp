@@ -0,0 +1,84 @@
+/** @defgroup group53 bytes_test
+ *  @ingroup group5
+ *  @{
+ */
+
+/**
+ * @file
+ * @brief This file contains tests for the BYTES value type of the adapter
+ * interface, which don't require a blockchain.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include "adapter_interface/adapter_interface.h"
+
+/**********************************************
+ *  Tests for the BYTES value type
+ ***********************************************/
+
+/**
+ * @brief Test that inline and heap allocated values survive copies and moves
+ *
+ */
+// NOLINTNEXTLINE(modernize-use-trailing-return-type)
+TEST(BytesTests /*unused*/, CopyAndMove /*unused*/) {
+  const std::string small(BYTES::INLINE_SIZE, 'k');
+  const std::string large(BYTES::INLINE_SIZE + 1, 'v');
+  for (const auto &content : {small, large}) {
+    BYTES original(content);
+    BYTES copy(original);
+    EXPECT_EQ(copy, original);
+    EXPECT_NE(copy.value, original.value);
+
+    const unsigned char *data = original.value;
+    BYTES moved(std::move(original));
+    EXPECT_EQ(moved, copy);
+    EXPECT_EQ(original.size, 0);
+    // heap arrays are taken over, inline bytes are copied
+    EXPECT_EQ(moved.value == data, content.size() > BYTES::INLINE_SIZE);
+
+    BYTES assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned, copy);
+    assigned = copy;
+    EXPECT_EQ(assigned, copy);
+  }
+}
+
+/**
+ * @brief Test that views borrow their bytes and copies of views own them
+ *
+ */
+// NOLINTNEXTLINE(modernize-use-trailing-return-type)
+TEST(BytesTests /*unused*/, View /*unused*/) {
+  unsigned char data[] = {1, 2, 3};
+  BYTES view = BYTES::view(data, sizeof(data));
+  EXPECT_TRUE(view.is_view());
+  EXPECT_EQ(view.value, data);
+
+  BYTES copy(view);
+  EXPECT_FALSE(copy.is_view());
+  EXPECT_EQ(copy, view);
+
+  BYTES moved(std::move(view));
+  EXPECT_TRUE(moved.is_view());
+  EXPECT_EQ(moved.value, data);
+}
+
+/**
+ * @brief Test that BYTES are ordered by size first and then by content
+ *
+ */
+// NOLINTNEXTLINE(modernize-use-trailing-return-type)
+TEST(BytesTests /*unused*/, Ordering /*unused*/) {
+  EXPECT_LT(BYTES("zz"), BYTES("aaa"));
+  EXPECT_LT(BYTES("aab"), BYTES("aba"));
+  EXPECT_FALSE(BYTES("aba") < BYTES("aba"));
+  EXPECT_EQ(BYTES(nullptr, 0), BYTES(""));
+  EXPECT_FALSE(BYTES(nullptr, 0) < BYTES(""));
+}
+/** @} */
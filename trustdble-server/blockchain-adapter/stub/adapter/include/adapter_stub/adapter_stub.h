@@ -14,20 +14,38 @@
 #include <iomanip>
 #include <iostream>
 #include <regex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "adapter_interface/adapter_interface.h"
 #include "adapter_utils/encoding_helpers.h"
 #include "blocknumber.h"
 #include "config_stub.h"
+#include "stub_segment.h"
+
+// minimum number of outdated records in a table file before it is compacted
+#define COMPACTION_MIN_DEAD_RECORDS 1024
 
 /**
- * @brief This BC_Adapter is a simple implementation that stores data in text
+ * @brief This BC_Adapter is a simple implementation that stores data in
  * files and provides all functionality of a bc adapter without the need to
  * deploy a real blockchain network.
  *
+ * @details Each table file is a binary segment (see StubSegment), an
+ * append-only log of checksummed records that is read through mmap. The
+ * adapter keeps an in-memory hash index from key to the offset of its latest
+ * record, which is updated incrementally from the end of the file, so writes
+ * of other adapter instances are picked up. Files are compacted once they
+ * contain more outdated than live records. Table files of the former text
+ * format are migrated when the table is loaded.
+ *
+ * The adapter is shared by the connections of the server, so index and
+ * mapping are guarded by a shared mutex that is held exclusively while they
+ * are refreshed or replaced. Appends and compactions of all adapter instances
+ * are serialized by an flock on the table file.
  */
 class StubAdapter : public BcAdapter {
  public:
@@ -36,6 +54,10 @@ class StubAdapter : public BcAdapter {
   //! Destructor
   ~StubAdapter() override;
 
+  //! The adapter owns the mapping of its table file and can't be copied
+  StubAdapter(const StubAdapter &) = delete;
+  auto operator=(const StubAdapter &) -> StubAdapter & = delete;
+
   /**********************************************
    *  BC_Adapter methods to be implemented
    ***********************************************/
@@ -47,7 +69,7 @@ class StubAdapter : public BcAdapter {
 
   /**
    * @brief Put a batch of key-value pairs into a file;
-   * Key-value pairs are stored in a file odd lines key, even lines value.
+   * Key-value pairs are appended to the file as records.
    *
    * @param batch Batch including multiple key-value pairs
    *
@@ -114,6 +136,15 @@ class StubAdapter : public BcAdapter {
       -> int override;
   auto drop_table() -> int override;
 
+  /**
+   * @brief The version of a table is derived from the modification time,
+   * inode and size of its file, which change with every put and remove.
+   *
+   * @param token Token to store the version in, the latest state is read
+   * @return Status code (0 on success, 1 on failure)
+   */
+  auto get_version(READ_TOKEN &token) -> int override;
+
   /**
    * @brief In this stub the block number is simulated by periodically
    * incrementing a counter in the background. The block number is used by the
@@ -159,9 +190,101 @@ class StubAdapter : public BcAdapter {
    */
   auto hasLockTimedOut(unsigned int blockTimeout) -> bool;
 
+  /**
+   * @brief Path of the file storing the table
+   *
+   * @return std::string
+   */
+  auto table_file() -> std::string;
+
+  /**
+   * @brief Path of the table file in the legacy text format
+   *
+   * @return std::string
+   */
+  auto text_table_file() -> std::string;
+
+  /**
+   * @brief Converts the table file from the legacy text format if there is no
+   * segment for the table yet
+   */
+  void migrate_if_needed();
+
+  /**
+   * @brief Adds all records appended to the table file since the last call to
+   * the index, remapping the file if it grew. The index is rebuilt if the file
+   * was replaced or truncated.
+   *
+   * @return true if the table file could be read
+   */
+  auto refresh_index() -> bool;
+
+  /**
+   * @brief Builds the index from the index record written with the segment
+   *
+   * @param index_offset Offset of the index record
+   * @return true if the index record is valid
+   */
+  auto load_segment_index(uint64_t index_offset) -> bool;
+
+  /**
+   * @brief Clears the index and unmaps the table file, so the index is rebuilt
+   * from the start of the file
+   */
+  void reset_index();
+
+  /**
+   * @brief Parses the record at an offset of the mapped table file
+   *
+   * @param offset Offset of the record
+   * @param record Reference to store the record
+   * @return true if a valid record was found
+   */
+  auto record_at(uint64_t offset, StubSegment::RECORD &record) -> bool;
+
+  /**
+   * @brief Opens the table file and locks it exclusively (flock). The file is
+   * reopened if a compaction replaced it while waiting for the lock.
+   *
+   * @param flags Flags to open the file with
+   * @return File descriptor holding the lock until it is closed, -1 on failure
+   */
+  auto lock_table_file(int flags) -> int;
+
+  /**
+   * @brief Appends records to the table file
+   *
+   * @param records Records encoded with StubSegment::append_record
+   * @return true on success
+   */
+  auto append(const std::string &records) -> bool;
+
+  /**
+   * @brief Rewrites the table file with live records only if it contains more
+   * outdated than live records
+   *
+   * @return true if the file was compacted or doesn't need compaction
+   */
+  auto compact_if_needed() -> bool;
+
   std::string tableName_;
   StubConfig config_;
   BlockNumber blockNumber_;
+
+  //! Index from key (raw bytes) to the offset of its latest record
+  std::unordered_map<std::string, uint64_t> index_;
+  //! Size of the table file that is covered by the index
+  uint64_t indexed_size_{0};
+  //! Inode of the indexed table file, changes if the file is replaced
+  uint64_t indexed_inode_{0};
+  //! Number of records (including outdated ones) in the indexed part
+  size_t record_count_{0};
+  //! Read-only mapping of the table file
+  const unsigned char *map_{nullptr};
+  //! Size of the mapping
+  size_t map_size_{0};
+  //! Guards index and mapping, held exclusively while they change
+  std::shared_mutex mutex_;
 };
 #endif  // StubAdapter_STUB_ADAPTER_H
 /** @} */
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*! \addtogroup group20
+ *  @{
+ */
+#ifndef StubAdapter_STUB_SEGMENT_H
+#define StubAdapter_STUB_SEGMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "adapter_interface/adapter_interface.h"
+
+// value line of a removed key in the legacy text format of table files
+#define TEXT_TOMBSTONE "-"
+
+/**
+ * @brief Binary on-disk format of stub adapter table files (segments).
+ *
+ * @details A segment starts with a header followed by an append-only sequence
+ * of length-prefixed records. All integers are stored in host byte order.
+ *
+ *     HEADER: magic "TDBSTUB\0" | uint32 format version | uint32 reserved
+ *             | uint64 offset of the index record (0 if there is none)
+ *     RECORD: uint32 CRC-32 | uint32 key length | uint32 value length
+ *             | key | value
+ *
+ * The checksum covers both lengths, the key and the value. A value length of
+ * TOMBSTONE_LENGTH marks the key as removed (the record carries no value).
+ * Segments written as a whole (compaction, migration) end their live records
+ * with an index record (key length INDEX_MARKER), whose value holds the
+ * uint64 offsets of all live records. Readers use it to build their index
+ * without walking every record; records appended later follow the index
+ * record.
+ */
+class StubSegment {
+ public:
+  //! Magic bytes at the start of every segment
+  static constexpr char MAGIC[8] = {'T', 'D', 'B', 'S', 'T', 'U', 'B', '\0'};
+  //! Version of the format written by this implementation
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  //! Size of the segment header
+  static constexpr size_t HEADER_SIZE = 24;
+  //! Size of the fixed part of a record (checksum and lengths)
+  static constexpr size_t RECORD_HEADER_SIZE = 12;
+  //! Value length of a record that removes its key
+  static constexpr uint32_t TOMBSTONE_LENGTH = UINT32_MAX;
+  //! Key length of the index record
+  static constexpr uint32_t INDEX_MARKER = UINT32_MAX;
+
+  /**
+   * @brief A record parsed from (or to be written to) a segment. Key and
+   * value point into the memory holding the segment.
+   */
+  struct RECORD {
+    const unsigned char *key{nullptr};
+    uint32_t key_length{0};
+    const unsigned char *value{nullptr};
+    uint32_t value_length{0};
+    //! Number of bytes the record occupies in the segment
+    size_t size{0};
+
+    auto is_tombstone() const -> bool {
+      return value_length == TOMBSTONE_LENGTH;
+    }
+    auto is_index() const -> bool { return key_length == INDEX_MARKER; }
+  };
+
+  /**
+   * @brief Encodes a record and appends it to a buffer
+   *
+   * @param out Buffer to append the record to
+   * @param key Key of the record
+   * @param value Value of the record, nullptr for a tombstone
+   */
+  static void append_record(std::string &out, const BYTES &key,
+                            const BYTES *value);
+
+  /**
+   * @brief Encodes the header of a segment
+   *
+   * @param index_offset Offset of the index record, 0 if there is none
+   * @return The encoded header
+   */
+  static auto encode_header(uint64_t index_offset) -> std::string;
+
+  /**
+   * @brief Validates the header of a segment
+   *
+   * @param data Start of the segment
+   * @param size Size of the segment
+   * @param index_offset Reference to store the offset of the index record
+   * @return 0 on success, 1 if the header is missing or invalid
+   */
+  static auto parse_header(const unsigned char *data, size_t size,
+                           uint64_t &index_offset) -> int;
+
+  /**
+   * @brief Parses and verifies the record at the start of data
+   *
+   * @param data Start of the record
+   * @param available Number of bytes readable at data
+   * @param record Reference to store the parsed record
+   * @return 0 on success, 1 if the record is incomplete (e.g. still being
+   * appended) or its checksum doesn't match
+   */
+  static auto parse_record(const unsigned char *data, size_t available,
+                           RECORD &record) -> int;
+
+  /**
+   * @brief Writes a complete segment containing the given records followed by
+   * an index record. The segment is written to a temporary file which then
+   * atomically replaces path.
+   *
+   * @param path Path of the segment
+   * @param records Live records of the segment, tombstones are not allowed
+   * @return 0 on success, 1 on failure
+   */
+  static auto write_segment(const std::string &path,
+                            const std::vector<RECORD> &records) -> int;
+
+  /**
+   * @brief Converts a table file of the legacy text format (hex encoded key
+   * and value lines) into a segment and removes the text file
+   *
+   * @param text_path Path of the text file
+   * @param segment_path Path of the segment to create
+   * @return 0 on success, 1 on failure
+   */
+  static auto migrate_text_table(const std::string &text_path,
+                                 const std::string &segment_path) -> int;
+};
+#endif  // StubAdapter_STUB_SEGMENT_H
+/** @} */
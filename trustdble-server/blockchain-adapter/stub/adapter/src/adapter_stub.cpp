@@ -3,8 +3,16 @@
  */
 #include "adapter_stub/adapter_stub.h"
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <map>
+#include <mutex>
 
 ////////////////////// Stub IMPLEMENTATION ///////////////////////////
 
@@ -12,7 +20,7 @@
 StubAdapter::StubAdapter() { BOOST_LOG_TRIVIAL(debug) << "stub: Constructor"; }
 
 // Destructor
-StubAdapter::~StubAdapter() = default;
+StubAdapter::~StubAdapter() { reset_index(); }
 
 auto StubAdapter::init(const std::string &config_path) -> bool {
   config_.init(config_path);
@@ -56,76 +64,32 @@ auto StubAdapter::init(const std::string &config_path,
 }
 
 auto StubAdapter::shutdown() -> bool {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  reset_index();
   this->tableName_ = "";
   return true;
 }
 
 auto StubAdapter::put(std::map<const BYTES, const BYTES> &batch) -> int {
-  std::string filename_old = config_.data_path() + "/" + tableName_ + ".txt";
-  std::string filename_new =
-      config_.data_path() + "/" + tableName_ + "_tmp.txt";
-  std::string line;
-
-  // Open old file
-  std::ifstream old_file(filename_old);
-  if (!old_file.is_open()) {
-    BOOST_LOG_TRIVIAL(debug)
-        << "stub: PUT, Failed to open File '" << filename_old << "'!";
-    return 1;
-  }
-
-  // Open new file
-  std::ofstream new_file(filename_new, std::fstream::out | std::fstream::app);
-  if (!new_file.is_open()) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!refresh_index()) {
     BOOST_LOG_TRIVIAL(debug)
-        << "stub: PUT, Failed to open File '" << filename_new << "'!";
-    old_file.close();
+        << "stub: PUT, Failed to open File '" << table_file() << "'!";
     return 1;
   }
 
-  // create iterator for the batch
-  std::map<const BYTES, const BYTES>::iterator it;
-
-  // Copy old file to new file
-  while (getline(old_file, line)) {
-    unsigned char *key = new unsigned char[line.size() / 2];
-    hex_to_byte_array(line, key);
-    BYTES bytes_line(key, line.size() / 2);
-    delete[] key;
-    // check if key is already in  the batch
-    it = batch.find(bytes_line);
-    if (it == batch.end()) {
-      new_file << line << "\n";
-      getline(old_file, line);
-      new_file << line << "\n";
-    } else {
-      getline(old_file, line);
-    }
-  }
-
   // append the key-value pairs included in the batch to the end of
-  // the file
-  for (it = batch.begin(); it != batch.end(); ++it) {
-    std::string key = byte_array_to_hex(it->first.value, it->first.size);
-    std::string value = byte_array_to_hex(it->second.value, it->second.size);
-    new_file << key << "\n";
-    new_file << value << "\n";
+  // the file with a single write
+  std::string records;
+  for (const auto &it : batch) {
+    StubSegment::append_record(records, it.first, &it.second);
   }
-
-  new_file.close();
-  old_file.close();
-
-  // Remove old file and rename new file
-  if (std::remove(filename_old.c_str()) != 0) {
-    BOOST_LOG_TRIVIAL(debug)
-        << "stub: PUT, Removing of file '" << filename_old << "' failed!";
-    return 1;
-  }
-  if (rename(filename_new.c_str(), filename_old.c_str()) != 0) {
+  if (!append(records)) {
     BOOST_LOG_TRIVIAL(debug)
-        << "stub: PUT, Renaming of file '" << filename_new << "' failed!";
+        << "stub: PUT, Failed to append to File '" << table_file() << "'!";
     return 1;
   }
+  compact_if_needed();
 
   // Put done
   BOOST_LOG_TRIVIAL(debug) << "stub: PUT, success";
@@ -150,39 +114,37 @@ auto StubAdapter::put(const std::string &key, const std::string &value,
 }
 
 auto StubAdapter::get(const BYTES &key, BYTES &result) -> int {
-  std::string line;
-
-  std::ifstream myfile(config_.data_path() + "/" + tableName_ + ".txt");
-
-  if (myfile.is_open()) {
-    while (getline(myfile, line)) {
-      unsigned char *line_byte = new unsigned char[line.length() / 2];
-      hex_to_byte_array(line, line_byte);
-      BYTES bytes_line(line_byte, line.length() / 2);
-      delete[] line_byte;
-      if (key == bytes_line) {
-        BOOST_LOG_TRIVIAL(debug) << "stub: GET, Success";
-        getline(myfile, line);
-        unsigned char *line_byte_end = new unsigned char[line.length() / 2];
-        hex_to_byte_array(line, line_byte_end);
-        myfile.close();
-        result = BYTES(line_byte_end, line.length() / 2);
-        delete[] line_byte_end;
-        return 0;
-      }
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!refresh_index()) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "stub: GET, Failed to open File " << table_file();
+      return 1;
     }
-    myfile.close();
+  }
+
+  // the mapping stays valid while the mutex is shared
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = index_.find(
+      std::string(reinterpret_cast<const char *>(key.value), key.size));
+  if (it == index_.end()) {
     BOOST_LOG_TRIVIAL(debug)
         << "stub: GET, No value for key %s found!"
         << std::string(reinterpret_cast<char *>(key.value), key.size);
     return 1;
   }
-  BOOST_LOG_TRIVIAL(debug)
 
-      << "stub: GET, Failed to open File " << config_.data_path().c_str() << "/"
-      << tableName_.c_str() << ".txt";
+  // copy the latest value of the key from the mapped file
+  StubSegment::RECORD record;
+  if (!record_at(it->second, record)) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: GET, Failed to read value from File " << table_file();
+    return 1;
+  }
+  result = BYTES(record.value, record.value_length);
 
-  return 1;
+  BOOST_LOG_TRIVIAL(debug) << "stub: GET, Success";
+  return 0;
 }
 
 auto StubAdapter::get(const std::string &key, std::string &result,
@@ -202,86 +164,67 @@ auto StubAdapter::get(const std::string &key, std::string &result,
 }
 
 auto StubAdapter::get_all(std::map<const BYTES, BYTES> &results) -> int {
-  std::string key;
-  std::string value;
-  std::ifstream myfile(config_.data_path() + "/" + tableName_ + ".txt");
-
-  if (myfile.is_open()) {
-    while (getline(myfile, key)) {
-      unsigned char *key_byte = new unsigned char[key.length() / 2];
-      hex_to_byte_array(key, key_byte);
-      getline(myfile, value);
-      unsigned char *value_byte = new unsigned char[value.length() / 2];
-      hex_to_byte_array(value, value_byte);
-      results.emplace(BYTES(key_byte, key.length() / 2),
-                      BYTES(value_byte, value.length() / 2));
-      delete[] value_byte;
-      delete[] key_byte;
+  bool refreshed = false;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    refreshed = refresh_index();
+  }
+  if (refreshed) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    // walk the live records in file order through the mapping
+    std::vector<uint64_t> offsets;
+    offsets.reserve(index_.size());
+    for (const auto &entry : index_) {
+      offsets.push_back(entry.second);
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    StubSegment::RECORD record;
+    for (uint64_t offset : offsets) {
+      if (!record_at(offset, record)) {
+        BOOST_LOG_TRIVIAL(debug)
+            << "stub: GET_ALL, Invalid record in File " << table_file();
+        return 1;
+      }
+      results.emplace(BYTES(record.key, record.key_length),
+                      BYTES(record.value, record.value_length));
     }
-    myfile.close();
     BOOST_LOG_TRIVIAL(debug) << "stub: GET_ALL, Success";
     return 0;
   }
   BOOST_LOG_TRIVIAL(debug)
 
-      << "stub: GET_ALL, Failed to open File " << config_.data_path().c_str()
-      << "/" << tableName_.c_str() << ".txt!";
+      << "stub: GET_ALL, Failed to open File " << table_file() << "!";
 
   return 1;
 }
 
 auto StubAdapter::remove(const BYTES &key) -> int {
-  std::string line;
-  bool key_found = false;
-
-  std::ifstream old_file(config_.data_path() + "/" + tableName_ + ".txt");
-  std::ofstream new_file(config_.data_path() + "/" + tableName_ + "_tmp.txt",
-                         std::fstream::out | std::fstream::app);
-
-  if (old_file.is_open() && new_file.is_open()) {
-    while (getline(old_file, line)) {
-      unsigned char *line_byte = new unsigned char[line.length() / 2];
-      hex_to_byte_array(line, line_byte);
-      BYTES bytes_line(line_byte, line.length() / 2);
-      delete[] line_byte;
-      if (key == bytes_line) {
-        getline(old_file, line);
-        key_found = true;
-      } else {
-        new_file << line << "\n";
-        getline(old_file, line);
-        new_file << line << "\n";
-      }
-    }
-    old_file.close();
-    new_file.close();
-
-    if (std::remove(
-            (config_.data_path() + "/" + tableName_ + ".txt").c_str()) == 0) {
-      // logg("Failed to delete File " + config.data_path() + "" + tableName +
-      // ".txt!","remove");
-
-      if (rename((config_.data_path() + "/" + tableName_ + "_tmp.txt").c_str(),
-                 (config_.data_path() + "/" + tableName_ + ".txt").c_str()) !=
-          0) {
-        // logg("Renaming failed!", "remove");
-        return 1;
-      }
-    }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!refresh_index()) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: REMOVE, Failed to open File" << table_file();
+    return 1;
+  }
 
-    if (key_found) {
-      BOOST_LOG_TRIVIAL(debug) << "stub: REMOVE, Success";
-      return 0;
-    }
+  if (index_.find(std::string(reinterpret_cast<const char *>(key.value),
+                              key.size)) == index_.end()) {
     BOOST_LOG_TRIVIAL(debug) << "stub: REMOVE, failed due to key not found";
     return 1;
   }
-  BOOST_LOG_TRIVIAL(debug)
 
-      << "stub: REMOVE, Failed to open File" << config_.data_path().c_str()
-      << "/" << tableName_.c_str() << ".txt";
+  // append a tombstone for the key
+  std::string record;
+  StubSegment::append_record(record, key, nullptr);
+  if (!append(record)) {
+    BOOST_LOG_TRIVIAL(debug) << "stub: REMOVE, Failed to append to File "
+                             << table_file();
+    return 1;
+  }
+  compact_if_needed();
 
-  return 1;
+  BOOST_LOG_TRIVIAL(debug) << "stub: REMOVE, Success";
+  return 0;
 }
 
 auto StubAdapter::remove(const std::string &key, const std::string &signature,
@@ -300,33 +243,39 @@ auto StubAdapter::remove(const std::string &key, const std::string &signature,
 
 auto StubAdapter::create_table(const std::string &name,
                                std::string &tableAddress) -> int {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   this->tableName_ = name;
-  std::ofstream myfile(this->config_.data_path() + "/" + tableName_ + ".txt",
-                       std::fstream::out | std::fstream::app);
+  reset_index();
+  migrate_if_needed();
 
-  if (myfile.is_open()) {
-    myfile.close();
+  // create an empty segment unless the table exists already
+  if (!boost::filesystem::exists(table_file()) &&
+      StubSegment::write_segment(table_file(), {}) != 0) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: CREATE_TABLE, Failed to create File " << table_file();
+    return 1;
   }
-  tableAddress = this->config_.data_path() + "/" + tableName_ + ".txt";
+  tableAddress = table_file();
   return 0;
 }
 
 auto StubAdapter::load_table(const std::string &name,
                              const std::string &tableAddress) -> int {
   (void)tableAddress;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   this->tableName_ = name;
-  std::ifstream myfile(this->config_.data_path() + "/" + tableName_ + ".txt");
-  if (myfile.is_open()) {
-    myfile.close();
-  } else {
+  reset_index();
+  migrate_if_needed();
+  if (!boost::filesystem::exists(table_file())) {
     return 1;
   }
   return 0;
 }
 
 auto StubAdapter::drop_table() -> int {
-  if (std::remove((config_.data_path() + "/" + tableName_ + ".txt").c_str()) !=
-      0) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  reset_index();
+  if (std::remove(table_file().c_str()) != 0) {
     BOOST_LOG_TRIVIAL(debug)
         << "stub: DROP_TABLE, Failed to delete File"
         << config_.data_path().c_str() << "/" << tableName_.c_str();
@@ -339,6 +288,260 @@ auto StubAdapter::drop_table() -> int {
   return 0;
 }
 
+auto StubAdapter::get_version(READ_TOKEN &token) -> int {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::string filename = table_file();
+  struct stat file_stat {};
+  if (stat(filename.c_str(), &file_stat) != 0) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: GET_VERSION, Failed to stat File " << filename;
+    return 1;
+  }
+  // put and remove append to the file and compaction replaces it, so combine
+  // inode, size and modification time to detect changes within the
+  // resolution of the file system clock
+  uint64_t version =
+      static_cast<uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000ULL +
+      static_cast<uint64_t>(file_stat.st_mtim.tv_nsec);
+  version = version * 31 + static_cast<uint64_t>(file_stat.st_ino);
+  version = version * 31 + static_cast<uint64_t>(file_stat.st_size);
+  token.version = version;
+  return 0;
+}
+
+auto StubAdapter::table_file() -> std::string {
+  return config_.data_path() + "/" + tableName_ + ".seg";
+}
+
+auto StubAdapter::text_table_file() -> std::string {
+  return config_.data_path() + "/" + tableName_ + ".txt";
+}
+
+void StubAdapter::migrate_if_needed() {
+  if (!boost::filesystem::exists(table_file()) &&
+      boost::filesystem::exists(text_table_file())) {
+    StubSegment::migrate_text_table(text_table_file(), table_file());
+  }
+}
+
+auto StubAdapter::refresh_index() -> bool {
+  int fd = open(table_file().c_str(), O_RDONLY);
+  if (fd < 0) {
+    reset_index();
+    return false;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    reset_index();
+    return false;
+  }
+  auto file_size = static_cast<uint64_t>(file_stat.st_size);
+  if (static_cast<uint64_t>(file_stat.st_ino) != indexed_inode_ ||
+      file_size < indexed_size_) {
+    // file was replaced (compaction, drop) or truncated, rebuild the index
+    reset_index();
+    indexed_inode_ = static_cast<uint64_t>(file_stat.st_ino);
+  }
+  if (file_size != map_size_) {
+    // the file grew, extend the mapping
+    if (map_ != nullptr) {
+      munmap(const_cast<unsigned char *>(map_), map_size_);
+      map_ = nullptr;
+      map_size_ = 0;
+    }
+    if (file_size > 0) {
+      void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapping == MAP_FAILED) {
+        close(fd);
+        reset_index();
+        return false;
+      }
+      map_ = static_cast<const unsigned char *>(mapping);
+      map_size_ = file_size;
+    }
+  }
+  close(fd);
+
+  if (indexed_size_ == 0) {
+    uint64_t index_offset = 0;
+    if (StubSegment::parse_header(map_, map_size_, index_offset) != 0) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "stub: Invalid segment header in File " << table_file();
+      reset_index();
+      return false;
+    }
+    indexed_size_ = StubSegment::HEADER_SIZE;
+    if (index_offset != 0 && !load_segment_index(index_offset)) {
+      BOOST_LOG_TRIVIAL(debug)
+          << "stub: Invalid index record in File " << table_file();
+    }
+  }
+
+  // only complete records are indexed, a concurrent writer may not have
+  // finished its append yet
+  StubSegment::RECORD record;
+  std::string key;
+  while (record_at(indexed_size_, record)) {
+    if (!record.is_index()) {
+      key.assign(reinterpret_cast<const char *>(record.key),
+                 record.key_length);
+      if (record.is_tombstone()) {
+        index_.erase(key);
+      } else {
+        index_[key] = indexed_size_;
+      }
+      record_count_++;
+    }
+    indexed_size_ += record.size;
+  }
+  return true;
+}
+
+auto StubAdapter::load_segment_index(uint64_t index_offset) -> bool {
+  StubSegment::RECORD index_record;
+  if (!record_at(index_offset, index_record) || !index_record.is_index() ||
+      index_record.value_length % sizeof(uint64_t) != 0) {
+    return false;
+  }
+
+  std::unordered_map<std::string, uint64_t> index;
+  size_t count = index_record.value_length / sizeof(uint64_t);
+  index.reserve(count);
+  StubSegment::RECORD record;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t offset = 0;
+    memcpy(&offset, index_record.value + i * sizeof(uint64_t), sizeof(offset));
+    if (!record_at(offset, record) || record.is_index() ||
+        record.is_tombstone()) {
+      return false;
+    }
+    index.emplace(std::string(reinterpret_cast<const char *>(record.key),
+                              record.key_length),
+                  offset);
+  }
+
+  index_ = std::move(index);
+  record_count_ = count;
+  indexed_size_ = index_offset + index_record.size;
+  return true;
+}
+
+void StubAdapter::reset_index() {
+  index_.clear();
+  indexed_size_ = 0;
+  indexed_inode_ = 0;
+  record_count_ = 0;
+  if (map_ != nullptr) {
+    munmap(const_cast<unsigned char *>(map_), map_size_);
+  }
+  map_ = nullptr;
+  map_size_ = 0;
+}
+
+auto StubAdapter::record_at(uint64_t offset, StubSegment::RECORD &record)
+    -> bool {
+  return offset < map_size_ &&
+         StubSegment::parse_record(map_ + offset, map_size_ - offset,
+                                   record) == 0;
+}
+
+auto StubAdapter::lock_table_file(int flags) -> int {
+  std::string filename = table_file();
+  while (true) {
+    int fd = open(filename.c_str(), flags);
+    if (fd < 0) {
+      return -1;
+    }
+    struct stat locked_stat {};
+    struct stat file_stat {};
+    if (flock(fd, LOCK_EX) != 0 || fstat(fd, &locked_stat) != 0) {
+      close(fd);
+      return -1;
+    }
+    // a compaction may have renamed a new file over the path while waiting
+    if (stat(filename.c_str(), &file_stat) == 0 &&
+        file_stat.st_ino == locked_stat.st_ino) {
+      return fd;
+    }
+    close(fd);
+    if (!boost::filesystem::exists(filename)) {
+      return -1;
+    }
+  }
+}
+
+auto StubAdapter::append(const std::string &records) -> bool {
+  // the lock keeps the append from landing in a file that is being compacted,
+  // a single write with O_APPEND keeps records of concurrent writers apart
+  int fd = lock_table_file(O_WRONLY | O_APPEND);
+  if (fd < 0) {
+    return false;
+  }
+  ssize_t written = write(fd, records.data(), records.size());
+  close(fd);
+  if (written != static_cast<ssize_t>(records.size())) {
+    return false;
+  }
+  // index the appended records
+  return refresh_index();
+}
+
+auto StubAdapter::compact_if_needed() -> bool {
+  size_t dead_records = record_count_ - index_.size();
+  if (dead_records < COMPACTION_MIN_DEAD_RECORDS ||
+      dead_records <= index_.size()) {
+    return true;
+  }
+
+  // Block appends of other instances and index the records they appended
+  // before, so none of them is lost by replacing the file
+  int fd = lock_table_file(O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  if (!refresh_index()) {
+    close(fd);
+    return false;
+  }
+  dead_records = record_count_ - index_.size();
+  if (dead_records < COMPACTION_MIN_DEAD_RECORDS ||
+      dead_records <= index_.size()) {
+    // another instance compacted the file already
+    close(fd);
+    return true;
+  }
+
+  // Copy the latest record of every live key, in file order
+  std::vector<uint64_t> offsets;
+  offsets.reserve(index_.size());
+  for (const auto &entry : index_) {
+    offsets.push_back(entry.second);
+  }
+  std::sort(offsets.begin(), offsets.end());
+  std::vector<StubSegment::RECORD> records(offsets.size());
+  for (size_t i = 0; i < offsets.size(); i++) {
+    if (!record_at(offsets[i], records[i])) {
+      close(fd);
+      return false;
+    }
+  }
+
+  // Replace old file, appenders waiting for the lock reopen the new file and
+  // readers of the old file rebuild their index
+  int status = StubSegment::write_segment(table_file(), records);
+  close(fd);
+  if (status != 0) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: COMPACT, Failed to rewrite File '" << table_file() << "'!";
+    return false;
+  }
+  BOOST_LOG_TRIVIAL(debug) << "stub: COMPACT, removed " << dead_records
+                           << " outdated records";
+  reset_index();
+  return refresh_index();
+}
+
 auto StubAdapter::getCurrentBlockNumber() -> unsigned int {
   return blockNumber_.get();
 }
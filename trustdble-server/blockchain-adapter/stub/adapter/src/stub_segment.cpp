@@ -0,0 +1,197 @@
+/*! \addtogroup group20
+ *  @{
+ */
+#include "adapter_stub/stub_segment.h"
+
+#include <boost/crc.hpp>
+#include <boost/log/trivial.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+constexpr char StubSegment::MAGIC[8];
+
+static auto checksum(const unsigned char *data, size_t size) -> uint32_t {
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+  return crc.checksum();
+}
+
+static void append_uint32(std::string &out, uint32_t value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void append_uint64(std::string &out, uint64_t value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/**
+ * @brief Appends a record and fills in its checksum once the payload is
+ * written
+ */
+static void append_raw_record(std::string &out, uint32_t key_length,
+                              uint32_t value_length, const unsigned char *key,
+                              size_t key_size, const unsigned char *value,
+                              size_t value_size) {
+  size_t start = out.size();
+  append_uint32(out, 0);
+  append_uint32(out, key_length);
+  append_uint32(out, value_length);
+  out.append(reinterpret_cast<const char *>(key), key_size);
+  out.append(reinterpret_cast<const char *>(value), value_size);
+
+  uint32_t crc = checksum(
+      reinterpret_cast<const unsigned char *>(out.data()) + start + 4,
+      out.size() - start - 4);
+  memcpy(&out[start], &crc, sizeof(crc));
+}
+
+void StubSegment::append_record(std::string &out, const BYTES &key,
+                                const BYTES *value) {
+  if (value == nullptr) {
+    append_raw_record(out, static_cast<uint32_t>(key.size), TOMBSTONE_LENGTH,
+                      key.value, key.size, nullptr, 0);
+  } else {
+    append_raw_record(out, static_cast<uint32_t>(key.size),
+                      static_cast<uint32_t>(value->size), key.value, key.size,
+                      value->value, value->size);
+  }
+}
+
+auto StubSegment::encode_header(uint64_t index_offset) -> std::string {
+  std::string header(MAGIC, sizeof(MAGIC));
+  append_uint32(header, FORMAT_VERSION);
+  append_uint32(header, 0);
+  append_uint64(header, index_offset);
+  return header;
+}
+
+auto StubSegment::parse_header(const unsigned char *data, size_t size,
+                               uint64_t &index_offset) -> int {
+  if (data == nullptr || size < HEADER_SIZE ||
+      memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    return 1;
+  }
+  uint32_t version = 0;
+  memcpy(&version, data + sizeof(MAGIC), sizeof(version));
+  if (version != FORMAT_VERSION) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: Unsupported segment format version " << version;
+    return 1;
+  }
+  memcpy(&index_offset, data + 16, sizeof(index_offset));
+  return 0;
+}
+
+auto StubSegment::parse_record(const unsigned char *data, size_t available,
+                               RECORD &record) -> int {
+  if (available < RECORD_HEADER_SIZE) {
+    return 1;
+  }
+  uint32_t crc = 0;
+  memcpy(&crc, data, sizeof(crc));
+  memcpy(&record.key_length, data + 4, sizeof(record.key_length));
+  memcpy(&record.value_length, data + 8, sizeof(record.value_length));
+
+  size_t key_size = record.is_index() ? 0 : record.key_length;
+  size_t value_size = record.is_tombstone() ? 0 : record.value_length;
+  if (available - RECORD_HEADER_SIZE < key_size ||
+      available - RECORD_HEADER_SIZE - key_size < value_size) {
+    return 1;
+  }
+  record.size = RECORD_HEADER_SIZE + key_size + value_size;
+  if (checksum(data + 4, record.size - 4) != crc) {
+    return 1;
+  }
+  record.key = data + RECORD_HEADER_SIZE;
+  record.value = record.key + key_size;
+  return 0;
+}
+
+auto StubSegment::write_segment(const std::string &path,
+                                const std::vector<RECORD> &records) -> int {
+  std::string segment = encode_header(0);
+  std::string offsets;
+  for (const auto &record : records) {
+    append_uint64(offsets, segment.size());
+    append_raw_record(segment, record.key_length, record.value_length,
+                      record.key, record.key_length, record.value,
+                      record.value_length);
+  }
+  // index record of the live records, referenced from the header
+  uint64_t index_offset = segment.size();
+  append_raw_record(segment, INDEX_MARKER,
+                    static_cast<uint32_t>(offsets.size()), nullptr, 0,
+                    reinterpret_cast<const unsigned char *>(offsets.data()),
+                    offsets.size());
+  memcpy(&segment[16], &index_offset, sizeof(index_offset));
+
+  std::string tmp_path = path + ".tmp";
+  std::ofstream file(tmp_path, std::fstream::out | std::fstream::trunc |
+                                   std::fstream::binary);
+  if (!file.is_open()) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: Failed to open File '" << tmp_path << "'!";
+    return 1;
+  }
+  file.write(segment.data(), static_cast<std::streamsize>(segment.size()));
+  file.close();
+  if (file.fail() || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: Failed to write segment '" << path << "'!";
+    std::remove(tmp_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+auto StubSegment::migrate_text_table(const std::string &text_path,
+                                     const std::string &segment_path) -> int {
+  std::ifstream text_file(text_path);
+  if (!text_file.is_open()) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "stub: MIGRATE, Failed to open File '" << text_path << "'!";
+    return 1;
+  }
+
+  // replay the text log, later lines overwrite earlier ones
+  std::map<std::string, std::string> rows;
+  std::string key;
+  std::string value;
+  std::string raw_key;
+  while (getline(text_file, key) && getline(text_file, value)) {
+    raw_key.assign(key.length() / 2, '\0');
+    BcAdapter::hex_to_byte_array(
+        key, reinterpret_cast<unsigned char *>(&raw_key[0]));
+    if (value == TEXT_TOMBSTONE) {
+      rows.erase(raw_key);
+      continue;
+    }
+    std::string &raw_value = rows[raw_key];
+    raw_value.assign(value.length() / 2, '\0');
+    BcAdapter::hex_to_byte_array(
+        value, reinterpret_cast<unsigned char *>(&raw_value[0]));
+  }
+  text_file.close();
+
+  std::vector<RECORD> records;
+  records.reserve(rows.size());
+  for (const auto &row : rows) {
+    RECORD record;
+    record.key = reinterpret_cast<const unsigned char *>(row.first.data());
+    record.key_length = static_cast<uint32_t>(row.first.size());
+    record.value = reinterpret_cast<const unsigned char *>(row.second.data());
+    record.value_length = static_cast<uint32_t>(row.second.size());
+    records.push_back(record);
+  }
+  if (write_segment(segment_path, records) != 0) {
+    return 1;
+  }
+  std::remove(text_path.c_str());
+
+  BOOST_LOG_TRIVIAL(debug) << "stub: MIGRATE, converted '" << text_path
+                           << "' with " << rows.size() << " rows";
+  return 0;
+}
+/** @} */
@@ -25,6 +25,210 @@ TEST(StubAdapterTests, willsucceed) {
   EXPECT_TRUE(true);
 }
 
+//! The version of a table has to change with every modification
+TEST(StubAdapterTests, versionChangesOnModification) {
+  StubAdapter stub = StubAdapter();
+  std::string tableAddress;
+  std::string db_folder = "./test_data/version_db";
+  std::filesystem::create_directories(db_folder);
+
+  ASSERT_TRUE(stub.init("./test-config.ini",
+                        "{\"Network\":{\"network-name\":\"version_db\"}}"));
+  ASSERT_EQ(stub.create_table("version_table", tableAddress), 0);
+
+  READ_TOKEN version_empty;
+  ASSERT_EQ(stub.get_version(version_empty), 0);
+
+  std::map<const BYTES, const BYTES> batch;
+  batch.emplace(BYTES("key"), BYTES("value"));
+  ASSERT_EQ(stub.put(batch), 0);
+  READ_TOKEN version_put;
+  ASSERT_EQ(stub.get_version(version_put), 0);
+  EXPECT_NE(version_empty.version, version_put.version);
+
+  READ_TOKEN version_unchanged;
+  ASSERT_EQ(stub.get_version(version_unchanged), 0);
+  EXPECT_EQ(version_put.version, version_unchanged.version);
+
+  ASSERT_EQ(stub.remove(BYTES("key")), 0);
+  READ_TOKEN version_remove;
+  ASSERT_EQ(stub.get_version(version_remove), 0);
+  EXPECT_NE(version_put.version, version_remove.version);
+
+  stub.drop_table();
+  stub.shutdown();
+  std::filesystem::remove_all(db_folder);
+}
+
+//! Overwritten and removed keys are dropped when the log is compacted
+TEST(StubAdapterTests, compactionKeepsLatestValues) {
+  StubAdapter stub = StubAdapter();
+  std::string tableAddress;
+  std::string db_folder = "./test_data/compaction_db";
+  std::filesystem::create_directories(db_folder);
+
+  ASSERT_TRUE(stub.init("./test-config.ini",
+                        "{\"Network\":{\"network-name\":\"compaction_db\"}}"));
+  ASSERT_EQ(stub.create_table("compaction_table", tableAddress), 0);
+
+  // overwrite the same keys until the log has to be compacted
+  const int rounds = COMPACTION_MIN_DEAD_RECORDS / 2 + 1;
+  for (int round = 0; round < rounds; round++) {
+    std::map<const BYTES, const BYTES> batch;
+    batch.emplace(BYTES("a"), BYTES("a" + std::to_string(round)));
+    batch.emplace(BYTES("b"), BYTES("b" + std::to_string(round)));
+    batch.emplace(BYTES("c"), BYTES("c" + std::to_string(round)));
+    ASSERT_EQ(stub.put(batch), 0);
+  }
+  ASSERT_EQ(stub.remove(BYTES("c")), 0);
+  EXPECT_LT(std::filesystem::file_size(db_folder + "/compaction_table.seg"),
+            3 * rounds * StubSegment::RECORD_HEADER_SIZE);
+
+  std::string last = std::to_string(rounds - 1);
+  BYTES value;
+  ASSERT_EQ(stub.get(BYTES("a"), value), 0);
+  EXPECT_EQ(value, BYTES("a" + last));
+  EXPECT_EQ(stub.get(BYTES("c"), value), 1);
+
+  // a second instance reads the compacted log
+  StubAdapter reader = StubAdapter();
+  ASSERT_TRUE(reader.init("./test-config.ini",
+                          "{\"Network\":{\"network-name\":\"compaction_db\"}}"));
+  ASSERT_EQ(reader.load_table("compaction_table", tableAddress), 0);
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(reader.get_all(results), 0);
+  ASSERT_EQ(results.size(), 2U);
+  EXPECT_EQ(results.at(BYTES("b")), BYTES("b" + last));
+
+  stub.drop_table();
+  stub.shutdown();
+  reader.shutdown();
+  std::filesystem::remove_all(db_folder);
+}
+
+//! Appends of other instances aren't lost when an instance compacts the log
+TEST(StubAdapterTests, compactionKeepsConcurrentAppends) {
+  std::string tableAddress;
+  std::string db_folder = "./test_data/concurrent_db";
+  std::filesystem::create_directories(db_folder);
+  const std::string network =
+      "{\"Network\":{\"network-name\":\"concurrent_db\"}}";
+
+  StubAdapter writers[2];
+  ASSERT_TRUE(writers[0].init("./test-config.ini", network));
+  ASSERT_EQ(writers[0].create_table("concurrent_table", tableAddress), 0);
+  ASSERT_TRUE(writers[1].init("./test-config.ini", network));
+  ASSERT_EQ(writers[1].load_table("concurrent_table", tableAddress), 0);
+
+  // every round overwrites some keys and adds a new one, so both instances
+  // compact the log several times while the other one appends
+  const int rounds = COMPACTION_MIN_DEAD_RECORDS;
+  std::vector<std::thread> threads;
+  for (int w = 0; w < 2; w++) {
+    threads.emplace_back([&writers, w, rounds] {
+      std::string prefix = std::to_string(w) + "_";
+      for (int round = 0; round < rounds; round++) {
+        std::map<const BYTES, const BYTES> batch;
+        for (int hot = 0; hot < 4; hot++) {
+          batch.emplace(BYTES(prefix + "hot" + std::to_string(hot)),
+                        BYTES(std::to_string(round)));
+        }
+        batch.emplace(BYTES(prefix + std::to_string(round)), BYTES("new"));
+        EXPECT_EQ(writers[w].put(batch), 0);
+      }
+    });
+  }
+  // a connection reading through the same instance while it is compacted
+  threads.emplace_back([&writers, rounds] {
+    for (int round = 0; round < rounds / 16; round++) {
+      std::map<const BYTES, BYTES> results;
+      EXPECT_EQ(writers[0].get_all(results), 0);
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(writers[0].get_all(results), 0);
+  EXPECT_EQ(results.size(), 2U * (rounds + 4));
+  EXPECT_LT(std::filesystem::file_size(db_folder + "/concurrent_table.seg"),
+            10 * rounds * StubSegment::RECORD_HEADER_SIZE);
+
+  writers[0].drop_table();
+  writers[0].shutdown();
+  writers[1].shutdown();
+  std::filesystem::remove_all(db_folder);
+}
+
+//! Tables of the text format are converted into segments when loaded
+TEST(StubAdapterTests, migrateTextTable) {
+  StubAdapter stub = StubAdapter();
+  std::string tableAddress;
+  std::string db_folder = "./test_data/migration_db";
+  std::filesystem::create_directories(db_folder);
+
+  // hex encoded key and value lines, "-" removes a key
+  std::ofstream text_file(db_folder + "/migration_table.txt");
+  text_file << "6b31\n" << "7631\n"   // k1 -> v1
+            << "6b32\n" << "7632\n"   // k2 -> v2
+            << "6b31\n" << "763162\n" // k1 -> v1b
+            << "6b32\n" << "-\n";     // remove k2
+  text_file.close();
+
+  ASSERT_TRUE(stub.init("./test-config.ini",
+                        "{\"Network\":{\"network-name\":\"migration_db\"}}"));
+  ASSERT_EQ(stub.load_table("migration_table", tableAddress), 0);
+  EXPECT_FALSE(std::filesystem::exists(db_folder + "/migration_table.txt"));
+
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(stub.get_all(results), 0);
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_EQ(results.at(BYTES("k1")), BYTES("v1b"));
+
+  stub.drop_table();
+  stub.shutdown();
+  std::filesystem::remove_all(db_folder);
+}
+
+//! Incomplete records at the end of a segment (e.g. a write in progress) are
+//! not indexed
+TEST(StubAdapterTests, ignorePartialRecord) {
+  StubAdapter stub = StubAdapter();
+  std::string tableAddress;
+  std::string db_folder = "./test_data/partial_db";
+  std::filesystem::create_directories(db_folder);
+
+  ASSERT_TRUE(stub.init("./test-config.ini",
+                        "{\"Network\":{\"network-name\":\"partial_db\"}}"));
+  ASSERT_EQ(stub.create_table("partial_table", tableAddress), 0);
+  std::map<const BYTES, const BYTES> batch;
+  batch.emplace(BYTES("key"), BYTES("value"));
+  ASSERT_EQ(stub.put(batch), 0);
+
+  // append the first half of another record
+  std::string record;
+  BYTES value("other_value");
+  StubSegment::append_record(record, BYTES("other_key"), &value);
+  std::ofstream segment(tableAddress, std::fstream::app | std::fstream::binary);
+  segment.write(record.data(), static_cast<std::streamsize>(record.size() / 2));
+  segment.close();
+
+  StubAdapter reader = StubAdapter();
+  ASSERT_TRUE(reader.init("./test-config.ini",
+                          "{\"Network\":{\"network-name\":\"partial_db\"}}"));
+  ASSERT_EQ(reader.load_table("partial_table", tableAddress), 0);
+  std::map<const BYTES, BYTES> results;
+  ASSERT_EQ(reader.get_all(results), 0);
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_EQ(results.at(BYTES("key")), BYTES("value"));
+
+  stub.drop_table();
+  stub.shutdown();
+  reader.shutdown();
+  std::filesystem::remove_all(db_folder);
+}
+
 /*
 TEST(StubAdapterTests, initTest) {
   StubAdapter stub = StubAdapter();
@@ -0,0 +1,58 @@
+/*! \addtogroup group20
+ *  @{
+ */
+/**
+ * @file
+ * @brief Converts stub adapter table files of the former text format into
+ * binary segments.
+ *
+ * Usage: stub_migrate <data-path> [<table> ...]
+ *
+ * Without table names all text table files found in data-path are converted.
+ */
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "adapter_stub/stub_segment.h"
+
+// file of the simulated block number, which isn't a table
+#define BLOCKNUMBER_FILE "blocknumber"
+
+auto main(int argc, char *argv[]) -> int {
+  if (argc < 2) {
+    std::cout << "Usage: " << argv[0] << " <data-path> [<table> ...]"
+              << std::endl;
+    return 1;
+  }
+  std::filesystem::path data_path(argv[1]);
+
+  std::vector<std::string> tables(argv + 2, argv + argc);
+  if (tables.empty()) {
+    for (const auto &entry : std::filesystem::directory_iterator(data_path)) {
+      if (entry.path().extension() == ".txt" &&
+          entry.path().stem() != BLOCKNUMBER_FILE) {
+        tables.push_back(entry.path().stem().string());
+      }
+    }
+  }
+
+  int status = 0;
+  for (const auto &table : tables) {
+    std::filesystem::path text_path = data_path / (table + ".txt");
+    std::filesystem::path segment_path = data_path / (table + ".seg");
+    if (std::filesystem::exists(segment_path)) {
+      std::cout << table << ": skipped, segment exists already" << std::endl;
+      continue;
+    }
+    if (StubSegment::migrate_text_table(text_path, segment_path) != 0) {
+      std::cout << table << ": migration failed" << std::endl;
+      status = 1;
+      continue;
+    }
+    std::cout << table << ": migrated" << std::endl;
+  }
+  return status;
+}
+/** @} */
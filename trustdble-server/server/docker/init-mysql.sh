@@ -56,7 +56,7 @@ tee ${TRUSTDBLE_SERVER_CONFIG_FILE} <<EOF
 connection-url=http://127.0.0.1:8000
 max-waiting-time=300
 script-path=/usr/local/mysql/_deps/trustdble-adapters-src/ethereum/scripts
-contract-path=/usr/local/mysql/_deps/trustdble-adapters-src/ethereum/contract/truffle/build/contracts/SimpleStorage.json
+contract-path=/usr/local/mysql/_deps/trustdble-adapters-src/ethereum/contract/truffle/build/contracts/TableStorageV2.json
 
 # STUB
 data-path=/stub/
@@ -35,7 +35,7 @@ void generateConfig(const std::string &config_path, const std::string &bctype,
          << "/trustdble-adapters-src/ethereum/scripts" << std::endl;
     file << "contract-path=" << dependency_dir
          << "/trustdble-adapters-src/ethereum/contract/truffle/build/contracts/"
-            "SimpleStorage.json"
+            "TableStorageV2.json"
          << std::endl;
 
     file << std::endl;
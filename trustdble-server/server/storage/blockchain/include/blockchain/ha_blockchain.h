@@ -69,9 +69,10 @@ struct ENCRYPTION_CONFIG {
   Class definition for the handler for blockchain storage engine
 */
 class ha_blockchain : public handler {
-  my_off_t current_position; // current position during table scan
-  std::vector<std::tuple<BYTES, BYTES>>
-      all_items; // buffer for table scan result
+  TableSnapshot scan_rows;            // rows pinned during a table scan
+  TABLE_MAP::const_iterator scan_next; // next row of the table scan
+  uchar current_key[MAX_BC_KEY_SIZE + 1]; // length and key of the last row
+                                          // read, stored by position()
 
 public:
   ha_blockchain(handlerton *hton, TABLE_SHARE *table_arg);
@@ -315,8 +316,15 @@ public:
    * Helper Methods
    *******************/
 
-  int find_current_row(uchar *buf);
-  int find_row(my_off_t index, uchar *buf);
+  /**
+   * @brief Copies a row of the table cache into the record buffer and
+   * remembers its key for position()
+   *
+   * @param[in] row key and value of the row
+   * @param[out] buf record buffer of the server
+   * @return 0
+   */
+  int read_row(const TABLE_MAP::value_type &row, uchar *buf);
 
   // Storage engine methods
   static handler *bc_create_handler(handlerton *hton, TABLE_SHARE *table,
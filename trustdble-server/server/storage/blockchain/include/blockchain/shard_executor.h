@@ -0,0 +1,65 @@
+#ifndef TRUSTDBLE_SHARD_EXECUTOR
+#define TRUSTDBLE_SHARD_EXECUTOR
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trustdble {
+
+/**
+ * @brief Bounded pool of worker threads that runs blockchain operations of
+ * different shards concurrently.
+ *
+ * @details Operations on a blockchain block until they are confirmed (e.g.
+ * mined), so sending the batches of all shards of a transaction one after
+ * another makes the commit latency grow with the number of shards. The pool
+ * never runs more than its number of threads operations at the same time,
+ * independent of the number of concurrent commits.
+ */
+class ShardExecutor {
+  public:
+    //! An operation on one shard, returns 0 on success
+    using TASK = std::function<int()>;
+
+    /**
+     * @brief Starts the worker threads of the pool
+     *
+     * @param num_threads Maximum number of tasks executed concurrently
+     */
+    explicit ShardExecutor(size_t num_threads);
+
+    //! Waits for all queued tasks and stops the worker threads
+    ~ShardExecutor();
+
+    ShardExecutor(const ShardExecutor &) = delete;
+    auto operator=(const ShardExecutor &) -> ShardExecutor & = delete;
+
+    /**
+     * @brief Runs tasks on the pool and waits until all of them finished. A
+     * single task is run on the calling thread.
+     *
+     * @param tasks Tasks to execute
+     * @return Status code of every task, in the order of tasks
+     */
+    auto run_all(std::vector<TASK> tasks) -> std::vector<int>;
+
+  private:
+    //! Loop of the worker threads
+    void work();
+
+    std::mutex mutex_;
+    std::condition_variable queue_changed_;
+    std::deque<std::packaged_task<int()>> queue_;
+    bool stopped_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace trustdble
+
+#endif // TRUSTDBLE_SHARD_EXECUTOR
@@ -0,0 +1,132 @@
+#ifndef TRUSTDBLE_TABLE_CACHE
+#define TRUSTDBLE_TABLE_CACHE
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "adapter_interface/adapter_interface.h"
+
+namespace trustdble {
+
+/**
+ * @brief Decrypted rows of a table, ordered by key
+ */
+using TABLE_MAP = std::map<BYTES, BYTES>;
+
+/**
+ * @brief Copy-on-write handle to the rows of a table.
+ *
+ * @details Snapshots handed out by the SharedTableCache share their rows with
+ * the cache and with all other transactions reading the same table version.
+ * The rows are only copied when a transaction modifies them for the first
+ * time, so read-only transactions never copy a table.
+ */
+class TableSnapshot {
+  public:
+    //! Constructs a snapshot of an empty table
+    TableSnapshot() : rows_(std::make_shared<TABLE_MAP>()) {}
+
+    /**
+     * @brief Read access to the rows of the snapshot
+     *
+     * @return Rows of the table
+     */
+    auto read() const -> const TABLE_MAP & { return *rows_; }
+
+    /**
+     * @brief Write access to the rows of the snapshot. Detaches the snapshot
+     * from all other holders of the rows by copying them if they are shared.
+     *
+     * @return Rows of the table owned exclusively by this snapshot
+     */
+    auto write() -> TABLE_MAP & {
+      if (rows_.use_count() > 1) {
+        rows_ = std::make_shared<TABLE_MAP>(*rows_);
+      }
+      return *rows_;
+    }
+
+  private:
+    std::shared_ptr<TABLE_MAP> rows_;
+};
+
+/**
+ * @brief Process-wide cache of decrypted tables that is shared by all
+ * connections.
+ *
+ * @details Each entry is tagged with the versions reported by the adapters of
+ * the table (one per shard, see BcAdapter::get_version). An entry is only
+ * returned by lookup() if all versions still match. Otherwise the entry is
+ * kept until it is replaced, so it can be brought up to date with the changes
+ * of the table instead of reading the table from the blockchain again. Tables
+ * whose adapters can not report a version are never cached.
+ */
+class SharedTableCache {
+  public:
+    /**
+     * @brief Get the cache instance of the process
+     *
+     * @return The shared table cache
+     */
+    static auto instance() -> SharedTableCache &;
+
+    /**
+     * @brief Looks up a table in the cache
+     *
+     * @param tablename Full name of the table ("./db/table")
+     * @param versions Current versions of the table's adapters
+     * @param snapshot Reference to store the cached rows
+     * @return 0 if an entry with matching versions was found, 1 otherwise
+     */
+    auto lookup(const std::string &tablename,
+                const std::vector<uint64_t> &versions,
+                TableSnapshot &snapshot) -> int;
+
+    /**
+     * @brief Looks up the entry of a table regardless of its versions, e.g. to
+     * bring outdated rows up to date with the changes of the table
+     *
+     * @param tablename Full name of the table ("./db/table")
+     * @param versions Reference to store the versions of the entry
+     * @param snapshot Reference to store the cached rows
+     * @return 0 if the table has an entry, 1 otherwise
+     */
+    auto lookup_outdated(const std::string &tablename,
+                         std::vector<uint64_t> &versions,
+                         TableSnapshot &snapshot) -> int;
+
+    /**
+     * @brief Stores the rows of a table in the cache, replacing an existing
+     * entry of the table
+     *
+     * @param tablename Full name of the table ("./db/table")
+     * @param versions Versions of the table's adapters read before the rows
+     * @param snapshot Rows of the table
+     */
+    void store(const std::string &tablename, std::vector<uint64_t> versions,
+               const TableSnapshot &snapshot);
+
+    /**
+     * @brief Removes a table from the cache, e.g. after it was modified
+     *
+     * @param tablename Full name of the table ("./db/table")
+     */
+    void invalidate(const std::string &tablename);
+
+  private:
+    struct ENTRY {
+      std::vector<uint64_t> versions;
+      TableSnapshot snapshot;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, ENTRY> entries_;
+};
+
+} // namespace trustdble
+
+#endif // TRUSTDBLE_TABLE_CACHE
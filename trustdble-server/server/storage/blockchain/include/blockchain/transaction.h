@@ -7,6 +7,7 @@
 #include <map>
 #include <cstring>
 #include "adapter_factory/adapter_factory.h"
+#include "blockchain/table_cache.h"
 using namespace std;
 
 namespace trustdble {
@@ -47,19 +48,21 @@ class Transaction {
      * @brief Adds a table to the table cache of this transaction
      *
      * @param tablename Name of the table
-     * @param table_map Table as map of strings (key, value)
+     * @param snapshot Copy-on-write snapshot of the table's rows
      * @return 0 if success
      */
-    auto addTable(const std::string &tablename, std::map<BYTES, BYTES> &table_map) -> int;
+    auto addTable(const std::string &tablename, TableSnapshot snapshot) -> int;
     /**
-     * @brief Adds a write statement to the statement list
+     * @brief Adds a write statement to the statement list. Key and value are
+     * moved into the statement, pass them with std::move if they are no
+     * longer needed.
      *
      * @param tablename Name of the table that statement belongs to
      * @param key The key of the write statement
      * @param value The value of the write statement
      * @return 0 if success
      */
-    auto addWrite(const std::string &tablename, BYTES &key,  BYTES &value) -> int;
+    auto addWrite(const std::string &tablename, BYTES key, BYTES value) -> int;
     /**
      * @brief Adds a remove statement to the statement list
      *
@@ -67,12 +70,13 @@ class Transaction {
      * @param key The key of the remove statement
      * @return 0 if success
      */
-    auto addRemove(const std::string &tablename, const BYTES &key) -> int;
+    auto addRemove(const std::string &tablename, BYTES key) -> int;
 
     // List of statements of the transaction
     std::vector<STATEMENT> statements;
-    // Cache holding all used tables of the transaction.
-    std::unordered_map<std::string, std::map<BYTES, BYTES>> table_cache;
+    // Cache holding all used tables of the transaction. Rows are shared with
+    // the SharedTableCache until the transaction modifies them.
+    std::unordered_map<std::string, TableSnapshot> table_cache;
     // Counter of locks
     ulong lock_count=0;
 };
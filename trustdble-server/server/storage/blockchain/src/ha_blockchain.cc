@@ -98,6 +98,7 @@
 
 #include <sql/sql_thd_internal_api.h>
 #include <sql/table.h>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -105,12 +106,15 @@
 #include <string>
 #include <unordered_map>
 #include "blockchain/crypt_service.h"
+#include "blockchain/shard_executor.h"
+#include "blockchain/table_cache.h"
 #include "my_sys.h"
 #include "mysql/components/services/log_builtins.h"
 #include "mysql/plugin.h"
 #include "sql/field.h"
 #include "sql/sql_base.h"
 #include "sql/sql_class.h"
+#include "sql/sql_error.h"
 #include "sql/sql_plugin.h"
 #include "sql/transaction.h"
 #include "typelib.h"
@@ -161,6 +165,16 @@ const std::string KEY_STORE_NAME = "key_store";
 
 // System variables for configuration
 static char *config_configuration_path;
+static uint config_shard_threads;
+static uint config_read_threads;
+
+// Worker pool sending the operations of different shards of a commit
+// concurrently
+static std::unique_ptr<ShardExecutor> shard_executor;
+// Worker pool reading versions, changes and rows of different shards
+// concurrently. Commits wait for blocks to be confirmed, so reads get their
+// own workers and never queue behind them.
+static std::unique_ptr<ShardExecutor> read_executor;
 
 /* Interface to mysqld, to check system tables supported by SE */
 static bool blockchain_is_supported_system_table(
@@ -179,6 +193,9 @@ static int blockchain_init_func(void *p) {
   blockchain_hton->rollback = ha_blockchain::bc_rollback;
   blockchain_hton->close_connection = ha_blockchain::bc_close_connection;
 
+  shard_executor = std::make_unique<ShardExecutor>(config_shard_threads);
+  read_executor = std::make_unique<ShardExecutor>(config_read_threads);
+
   return 0;
 }
 
@@ -244,6 +261,28 @@ int ha_blockchain::get_data_chain_for_key(std::string key,
   return id;
 }
 
+/**
+  @brief
+  Operation of a transaction on one shard: a batch of writes or the removal
+  of a single key.
+*/
+struct SHARD_OPERATION {
+  STATEMENT_TYPE type;
+  std::map<const BYTES, const BYTES> batch;
+  BYTES key;
+};
+
+/**
+  @brief
+  Operations of a transaction on one shard, executed in order.
+*/
+struct SHARD_COMMIT {
+  BcAdapter *adapter = nullptr;
+  std::vector<SHARD_OPERATION> operations;
+  // Write batches sent to the shard whose commit is not awaited yet
+  std::vector<std::string> transactions;
+};
+
 // Commit transaction
 int ha_blockchain::bc_commit(handlerton *, THD *thd, bool commit_trx) {
   DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: bc_commit"));
@@ -267,10 +306,10 @@ int ha_blockchain::bc_commit(handlerton *, THD *thd, bool commit_trx) {
 
   if (txn == nullptr) return 0;
 
-  // intermediate data structure for batching write transactions.for every table
-  // we store all the write statements that operate on that table.
-  std::map<std::string, std::map<const BYTES, const BYTES>> write_batch_map;
-  // Loop over all statements and send them to the blockchain
+  // Phase 1: group the statements into an ordered list of operations per
+  // shard (bc_adapter_map_key). Nothing is sent before all adapters are known.
+  std::map<std::string, SHARD_COMMIT> shard_commits;
+  // Loop over all statements
   for (unsigned int i = 0; i < txn->statements.size(); i++) {
     std::string full_table_name = std::string(txn->statements[i].tablename);
     std::string database_name =
@@ -315,27 +354,33 @@ int ha_blockchain::bc_commit(handlerton *, THD *thd, bool commit_trx) {
                   tablename.c_str()));
       return 1;
     }
-    std::map<std::string, std::map<const BYTES, const BYTES>>::iterator
-        table_it = write_batch_map.find(bc_adapter_map_key);
-    if (table_it == write_batch_map.end()) {
-      std::map<const BYTES, const BYTES> write_batch;
-      write_batch_map.emplace(bc_adapter_map_key, write_batch);
-      table_it = write_batch_map.find(bc_adapter_map_key);
-    }
+    SHARD_COMMIT &shard_commit = shard_commits[bc_adapter_map_key];
+    shard_commit.adapter = it->second.get();
+    std::vector<SHARD_OPERATION> &operations = shard_commit.operations;
+
     // High level logic of the following lines:
     // Assume the following transaction order (W=Write, R=Remove): W1, W2, R1,
     // W3, W4, W5, R2 In this case, we batch W1 and W2 and send them together to
     // the blockchain; then R1 is executed Afterwards, W3-W5 are batched and
     // sent to the blockchain; lastly, R2 is executed
     if (txn->statements[i].type == STATEMENT_TYPE::WRITE) {
+      if (operations.empty() ||
+          operations.back().type != STATEMENT_TYPE::WRITE) {
+        operations.emplace_back();
+        operations.back().type = STATEMENT_TYPE::WRITE;
+      }
+      std::map<const BYTES, const BYTES> &write_batch = operations.back().batch;
+      // a later write of the same key replaces the earlier one in the batch
+      write_batch.erase(txn->statements[i].key);
+
       size_t value_size = txn->statements[i].value.size;
       // if database has encryption key then the tables of corresponding
       // database will have encryption key and iv so key and value should be
       // encrypted
       if (encryption_config_map.find(database_name) !=
           encryption_config_map.end()) {
-        unsigned char *encrypted_value = new unsigned char[value_size + 256];
-        size_t encrypted_value_size;
+        // encrypt directly into the value of the batch entry
+        BYTES encrypted_value_bytes(value_size + 256);
 
         // if table is on meta chain (meta_table, data_chains, shared_tables)
         // its data should be encrypted using it's corresponding database
@@ -344,58 +389,109 @@ int ha_blockchain::bc_commit(handlerton *, THD *thd, bool commit_trx) {
             (table_name == META_TABLE_DATA_CHAINS_NAME) ||
             (table_name == SHARED_TABLES_NAME) ||
             (table_name == KEY_STORE_NAME)) {
-          encrypted_value_size =
+          encrypted_value_bytes.size =
               encrypt(txn->statements[i].value.value, value_size,
                       encryption_config_map[database_name].encryption_key,
                       encryption_config_map[database_name].encryption_iv,
-                      encrypted_value);
+                      encrypted_value_bytes.value);
         }
         // if table is not meta_table its data should be encrypted using table's
         // encryption key and iv
         else {
-          encrypted_value_size =
+          encrypted_value_bytes.size =
               encrypt(txn->statements[i].value.value, value_size,
                       encryption_config_map[full_table_name].encryption_key,
                       encryption_config_map[full_table_name].encryption_iv,
-                      encrypted_value);
+                      encrypted_value_bytes.value);
         }
-        // create BYTES struct from encrypted_value
-        BYTES encrypted_value_bytes =
-            BYTES(encrypted_value, encrypted_value_size);
-        table_it->second.emplace(txn->statements[i].key, encrypted_value_bytes);
-
-        // delete all allocated memory
-        delete[] encrypted_value;
+        write_batch.emplace(std::move(txn->statements[i].key),
+                            std::move(encrypted_value_bytes));
 
       } else {
-        // create BYTES struct from value
-        BYTES value_bytes = BYTES(txn->statements[i].value.value, value_size);
-        table_it->second.emplace(txn->statements[i].key, value_bytes);
+        // the statement is not used after commit, so move key and value
+        write_batch.emplace(std::move(txn->statements[i].key),
+                            std::move(txn->statements[i].value));
       }
 
     } else if (txn->statements[i].type == STATEMENT_TYPE::REMOVE) {
-      // If a remove statement occurs, then first check if we have elements in
-      // the batch Add the elements in the batch to the blockchain and then
-      // clear the batch
-      if (table_it->second.size() != 0) {
-        it->second->put(table_it->second);
-        table_it->second.clear();
-      }
-      // Then the remove statement is executed afterwards
-      it->second->remove(txn->statements[i].key);
+      // A remove is executed after the writes batched before it
+      operations.emplace_back();
+      operations.back().type = STATEMENT_TYPE::REMOVE;
+      operations.back().key = std::move(txn->statements[i].key);
     }
   }
-  // send all of the elements of write_batch to the blockchain
-  for (auto table_it = write_batch_map.begin();
-       table_it != write_batch_map.end(); table_it++) {
-    if (table_it->second.size() != 0) {
-      auto it = bc_adapter_map.find(table_it->first);
-      it->second->put(table_it->second);
+
+  // Phase 2: send the operations of all shards concurrently, the operations
+  // of one shard are executed in order. Write batches are only sent, their
+  // commit is awaited before a following remove of the shard.
+  std::vector<std::string> shard_keys;
+  std::vector<ShardExecutor::TASK> tasks;
+  for (auto &shard_commit : shard_commits) {
+    shard_keys.push_back(shard_commit.first);
+    tasks.emplace_back([commit = &shard_commit.second]() -> int {
+      for (auto &operation : commit->operations) {
+        int status = 0;
+        if (operation.type == STATEMENT_TYPE::WRITE) {
+          status = commit->adapter->put_async(operation.batch,
+                                              commit->transactions);
+        } else {
+          // the removed keys may have been written by the batches sent before
+          status = commit->adapter->await_puts(commit->transactions);
+          commit->transactions.clear();
+          if (status == 0) status = commit->adapter->remove(operation.key);
+        }
+        // later operations of the shard may depend on this one
+        if (status != 0) return status;
+      }
+      return 0;
+    });
+  }
+  std::vector<int> results = shard_executor->run_all(std::move(tasks));
+
+  // Phase 3: wait until the write batches of all shards are committed, so
+  // their ordering overlaps even if there are more shards than workers. The
+  // batches are already sent, so they are awaited on this thread instead of
+  // holding workers other commits need. The adapter is shared with other
+  // connections, so only the transactions of this commit are awaited.
+  size_t shard = 0;
+  for (auto &shard_commit : shard_commits) {
+    SHARD_COMMIT &commit = shard_commit.second;
+    int status = commit.adapter->await_puts(commit.transactions);
+    if (results[shard] == 0) results[shard] = status;
+    shard++;
+  }
+
+  // Report the outcome, shards that succeeded can't be rolled back, so a
+  // partial failure has to be surfaced to the client
+  std::string failed_shards;
+  for (size_t i = 0; i < results.size(); i++) {
+    DBUG_PRINT(LOG_TAG, ("bc_commit: shard %s, status = %d",
+                         shard_keys[i].c_str(), results[i]));
+    if (results[i] != 0) {
+      failed_shards += (failed_shards.empty() ? "" : ", ") + shard_keys[i];
     }
   }
+  // The cached rows of the written tables are not dropped: the commit changed
+  // the versions of their shards, so the next read brings the rows up to date
+  // with the changes since the cached versions.
+
   // Remove transaction
   delete txn;
   thd->get_ha_data(blockchain_hton->slot)->ha_ptr = nullptr;
+
+  if (!failed_shards.empty()) {
+    size_t num_failed =
+        results.size() -
+        static_cast<size_t>(std::count(results.begin(), results.end(), 0));
+    DBUG_PRINT(LOG_TAG, ("BC_COMMIT: %zu of %zu shards failed: %s", num_failed,
+                         results.size(), failed_shards.c_str()));
+    push_warning_printf(
+        thd, Sql_condition::SL_WARNING, ER_ERROR_DURING_COMMIT,
+        "Blockchain commit failed on %zu of %zu shards (%s), the other "
+        "shards were committed",
+        num_failed, results.size(), failed_shards.c_str());
+    return 1;
+  }
   return 0;
 }
 
@@ -440,6 +536,9 @@ int ha_blockchain::bc_close_connection(handlerton *hton, THD *thd) {
 
 ha_blockchain::ha_blockchain(handlerton *hton, TABLE_SHARE *table_arg)
     : handler(hton, table_arg) {
+  // position() stores the key of a row in ref: one byte length + key
+  ref_length = MAX_BC_KEY_SIZE + 1;
+  current_key[0] = 0;
   // DBUG_TRACE;
   // DBUG_PRINT(LOG_TAG, ("Constructor:"));
 }
@@ -869,6 +968,9 @@ int ha_blockchain::close() {
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
 
+  // Drop cached rows of the table
+  SharedTableCache::instance().invalidate(full_table_name.str());
+
   // Delete Adapter from map
   auto it = bc_adapter_map.find(full_table_name.str());
   if (it != bc_adapter_map.end()) {
@@ -989,13 +1091,15 @@ int ha_blockchain::write_row(uchar *buf) {
   full_table_name << table->s->db.str;
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
-  if (txn->table_cache.at(full_table_name.str()).find(key_bytes) !=
-      txn->table_cache.at(full_table_name.str()).end()) {
+  const TABLE_MAP &rows = txn->table_cache.at(full_table_name.str()).read();
+  if (rows.find(key_bytes) != rows.end()) {
     return HA_ERR_WRONG_COMMAND;
   }
-  txn->addWrite(full_table_name.str(), key_bytes, value_bytes);
   // Execute write in table cache of transaction
-  txn->table_cache.at(full_table_name.str())[key_bytes] = value_bytes;
+  txn->table_cache.at(full_table_name.str()).write().emplace(key_bytes,
+                                                             value_bytes);
+  txn->addWrite(full_table_name.str(), std::move(key_bytes),
+                std::move(value_bytes));
   return 0;
 }
 
@@ -1062,9 +1166,11 @@ int ha_blockchain::update_row(const uchar *old_data, uchar *new_data) {
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
 
-  txn->addWrite(full_table_name.str(), key_bytes_new, new_value_bytes);
   // Execute write in table cache of transaction
-  txn->table_cache.at(full_table_name.str())[key_bytes_new] = new_value_bytes;
+  txn->table_cache.at(full_table_name.str()).write().insert_or_assign(
+      key_bytes_new, new_value_bytes);
+  txn->addWrite(full_table_name.str(), std::move(key_bytes_new),
+                std::move(new_value_bytes));
   return 0;
 }
 
@@ -1105,9 +1211,9 @@ int ha_blockchain::delete_row(const uchar *buf) {
   full_table_name << table->s->db.str;
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
-  txn->addRemove(full_table_name.str(), key_bytes);
   // Execute remove in table cache of transaction
-  txn->table_cache.at(full_table_name.str()).erase(key_bytes);
+  txn->table_cache.at(full_table_name.str()).write().erase(key_bytes);
+  txn->addRemove(full_table_name.str(), std::move(key_bytes));
   return 0;
 }
 
@@ -1203,7 +1309,8 @@ int ha_blockchain::index_last(uchar *record) {
   // Fill record with zeros
   memset(record, 0, table->s->reclength);
 
-  auto table_cache = txn->table_cache.at(full_table_name.str());
+  const auto &table_cache =
+      txn->table_cache.at(full_table_name.str()).read();
 
   if(table_cache.empty()){
     // If table cache is empty set nullptr and return
@@ -1215,8 +1322,8 @@ int ha_blockchain::index_last(uchar *record) {
   max_row = table_cache.begin()->second;
 
   // Find row with biggest key
-  for (auto entry : table_cache){
-    auto next_row = entry.second;
+  for (const auto &entry : table_cache){
+    const auto &next_row = entry.second;
     if(memcmp(next_row.value+offset, max_row.value+offset, key_size)>0){
       max_row = next_row;
     }
@@ -1303,9 +1410,6 @@ int ha_blockchain::index_read(uchar *buf, const uchar *key, uint,
     return HA_ERR_WRONG_COMMAND;
   }
 
-  // determine the number of leading null bytes in the resulting array
-  uint initial_null_bytes = table->s->null_bytes;
-
   // set all elements of buf (=record) to 0
   memset(buf, 0, table->s->reclength);
 
@@ -1330,15 +1434,15 @@ int ha_blockchain::index_read(uchar *buf, const uchar *key, uint,
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
 
-  auto table_cache = txn->table_cache.at(full_table_name.str());
+  const auto &table_cache =
+      txn->table_cache.at(full_table_name.str()).read();
   auto result_it = table_cache.find(key_bytes);
 
   // if an element was found, then value result is non empty and further
   // processing is necessary
   if (result_it != table_cache.end()) {
     // copy the value into the buffer
-    memcpy(buf + initial_null_bytes, result_it->second.value,
-           result_it->second.size);
+    read_row(*result_it, buf);
   }
 
   // free the memory that was used for storing the adjusted key pointer => MySQL
@@ -1369,9 +1473,6 @@ int ha_blockchain::rnd_init(bool) {
   //  DBUG_TRACE;
   //  DBUG_PRINT(LOG_TAG, ("RND_INIT:"));
 
-  // Position in result vector
-  current_position = -1;
-
   // Get table cache of transaction
   Transaction *txn = static_cast<Transaction *>(
       ha_thd()->get_ha_data(blockchain_hton->slot)->ha_ptr);
@@ -1381,11 +1482,10 @@ int ha_blockchain::rnd_init(bool) {
   full_table_name << "/";
   full_table_name << table->s->table_name.str;
 
-  auto table_cache = txn->table_cache.at(full_table_name.str());
-  for (auto entry : table_cache) {
-    auto tuple = std::make_tuple(entry.first, entry.second);
-    all_items.push_back(tuple);
-  }
+  // Pin the rows of the table for the scan, so the cursor stays valid if the
+  // statement modifies the table (that modification copies the rows instead)
+  scan_rows = txn->table_cache.at(full_table_name.str());
+  scan_next = scan_rows.read().begin();
 
   return 0;
 }
@@ -1395,8 +1495,9 @@ int ha_blockchain::rnd_end() {
   //  DBUG_TRACE;
   //  DBUG_PRINT(LOG_TAG, ("RND_END:"));
 
-  // Clear read cache
-  all_items.clear();
+  // Release pinned rows
+  scan_rows = TableSnapshot();
+  scan_next = scan_rows.read().end();
 
   return 0;
 }
@@ -1420,12 +1521,12 @@ int ha_blockchain::rnd_next(uchar *buf) {
   // DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: rnd_next"));
   //  DBUG_TRACE;
 
-  current_position++;  // necessary to do before fetching row so that
-                       // position() still works
-
-  // DBUG_PRINT(LOG_TAG, ("RND_NEXT: position=%llu", current_position));
+  if (scan_next == scan_rows.read().end()) {
+    return HA_ERR_END_OF_FILE;
+  }
 
-  return find_current_row(buf);
+  // advance the cursor, read_row() remembers the key for position()
+  return read_row(*scan_next++, buf);
 }
 
 /**
@@ -1444,6 +1545,9 @@ int ha_blockchain::rnd_next(uchar *buf) {
   current_position should be the offset. If it is a primary key like in
   BDB, then it needs to be a primary key.
 
+  We store the key of the last row read (length byte followed by the key),
+  which stays valid while rows are inserted or removed.
+
   Called from filesort.cc, sql_select.cc, sql_delete.cc, and sql_update.cc.
 
   @see
@@ -1452,8 +1556,7 @@ int ha_blockchain::rnd_next(uchar *buf) {
 void ha_blockchain::position(const uchar *) {
   DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: position"));
   // DBUG_TRACE;
-  // DBUG_PRINT(LOG_TAG, ("POSITION: %llu", current_position));
-  my_store_ptr(ref, ref_length, current_position);
+  memcpy(ref, current_key, ref_length);
 }
 
 /**
@@ -1474,11 +1577,23 @@ int ha_blockchain::rnd_pos(uchar *buf, uchar *pos) {
   DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: rnd_pos"));
   // DBUG_TRACE;
 
-  auto position = my_get_ptr(pos, ref_length);
+  // Get table cache of transaction, the scan may already have ended
+  Transaction *txn = static_cast<Transaction *>(
+      ha_thd()->get_ha_data(blockchain_hton->slot)->ha_ptr);
+  std::stringstream full_table_name;
+  full_table_name << "./";
+  full_table_name << table->s->db.str;
+  full_table_name << "/";
+  full_table_name << table->s->table_name.str;
 
-  // DBUG_PRINT(LOG_TAG, ("RND_POS: pos=%llu", position));
+  const auto &table_cache =
+      txn->table_cache.at(full_table_name.str()).read();
+  auto result_it = table_cache.find(BYTES(pos + 1, pos[0]));
+  if (result_it == table_cache.end()) {
+    return HA_ERR_KEY_NOT_FOUND;
+  }
 
-  return find_row(position, buf);
+  return read_row(*result_it, buf);
 }
 
 /**
@@ -1567,6 +1682,194 @@ int ha_blockchain::delete_all_rows() {
   return HA_ERR_WRONG_COMMAND;
 }
 
+/**
+  @brief
+  Decrypts a value read from an adapter, if the table is encrypted.
+
+  @param value      Value of a row, replaced by the decrypted value
+  @param encryption Key and iv to decrypt the value, nullptr if not encrypted
+*/
+static void decrypt_value(BYTES &value, const ENCRYPTION_CONFIG *encryption) {
+  if (encryption == nullptr) {
+    return;
+  }
+  BYTES decrypted_bytes(value.size);
+  decrypted_bytes.size =
+      decrypt(value.value, value.size, encryption->encryption_key,
+              encryption->encryption_iv, decrypted_bytes.value);
+  value = std::move(decrypted_bytes);
+}
+
+/**
+  @brief
+  Brings the outdated rows of a table up to date by applying the changes each
+  shard reports since its cached version (BcAdapter::get_changes), instead of
+  reading all rows again. Shards whose version did not change are skipped.
+
+  @param adapters        Adapters of all shards of the table
+  @param cached_versions Versions of the shards the rows belong to
+  @param tokens          Current versions of the shards (get_version)
+  @param encryption      Key and iv to decrypt the rows, nullptr if not
+                         encrypted
+  @param snapshot        Rows of the table, updated on success
+
+  @return 0 on success, 1 if a shard could not report its changes
+*/
+static auto update_table_snapshot(const std::vector<BcAdapter *> &adapters,
+                                  const std::vector<uint64_t> &cached_versions,
+                                  const std::vector<READ_TOKEN> &tokens,
+                                  const ENCRYPTION_CONFIG *encryption,
+                                  TableSnapshot &snapshot) -> int {
+  std::vector<std::map<const BYTES, BYTES>> shard_puts(adapters.size());
+  std::vector<std::vector<BYTES>> shard_removes(adapters.size());
+  std::vector<ShardExecutor::TASK> change_tasks;
+  for (size_t i = 0; i < adapters.size(); i++) {
+    if (cached_versions[i] == tokens[i].version) {
+      continue;
+    }
+    change_tasks.emplace_back([adapter = adapters[i], since = cached_versions[i],
+                               &token = tokens[i], &puts = shard_puts[i],
+                               &removes = shard_removes[i], encryption] {
+      int status = adapter->get_changes(since, token, puts, removes);
+      for (auto &entry : puts) {
+        decrypt_value(entry.second, encryption);
+      }
+      return status;
+    });
+  }
+  std::vector<int> change_results =
+      read_executor->run_all(std::move(change_tasks));
+  if (std::count(change_results.begin(), change_results.end(), 0) !=
+      static_cast<std::ptrdiff_t>(change_results.size())) {
+    return 1;
+  }
+
+  // copies the rows once if they are shared with other transactions
+  TABLE_MAP &rows = snapshot.write();
+  size_t changes = 0;
+  for (size_t i = 0; i < adapters.size(); i++) {
+    for (const auto &key : shard_removes[i]) {
+      rows.erase(key);
+    }
+    for (auto &entry : shard_puts[i]) {
+      rows.insert_or_assign(entry.first, std::move(entry.second));
+    }
+    changes += shard_removes[i].size() + shard_puts[i].size();
+  }
+  DBUG_PRINT(LOG_TAG, ("update_table_snapshot: applied %zu changes", changes));
+  return 0;
+}
+
+/**
+  @brief
+  Reads all rows of a table from its adapters, scanning and decrypting all
+  shards concurrently on the read executor. The rows are
+  taken from the SharedTableCache if the versions of all adapters still match
+  the cached entry. Outdated cached rows are brought up to date with the
+  changes of the shards if all adapters can report them. Otherwise each
+  adapter scans its shard as of the version it reported, so the cached rows
+  match their versions.
+
+  @param tablename  Full name of the table ("./db/table")
+  @param adapters   Adapters of all shards of the table
+  @param encryption Key and iv to decrypt the rows, nullptr if not encrypted
+
+  @return Copy-on-write snapshot of the table's rows
+*/
+static auto load_table_snapshot(const std::string &tablename,
+                                const std::vector<BcAdapter *> &adapters,
+                                const ENCRYPTION_CONFIG *encryption)
+    -> TableSnapshot {
+  SharedTableCache &cache = SharedTableCache::instance();
+
+  // Versions are read before the rows, so a concurrent change can only make
+  // the cached rows look older than they are, never newer. The tokens carry
+  // the position each shard is read at to get_changes and get_all_at.
+  std::vector<READ_TOKEN> tokens(adapters.size());
+  std::vector<ShardExecutor::TASK> version_tasks;
+  for (size_t i = 0; i < adapters.size(); i++) {
+    version_tasks.emplace_back([adapter = adapters[i], &token = tokens[i]] {
+      return adapter->get_version(token);
+    });
+  }
+  std::vector<int> version_results =
+      read_executor->run_all(std::move(version_tasks));
+  bool versioned =
+      !adapters.empty() &&
+      std::count(version_results.begin(), version_results.end(), 0) ==
+          static_cast<std::ptrdiff_t>(version_results.size());
+  std::vector<uint64_t> versions(adapters.size(), 0);
+  for (size_t i = 0; i < adapters.size(); i++) {
+    versions[i] = tokens[i].version;
+  }
+
+  TableSnapshot snapshot;
+  if (versioned && cache.lookup(tablename, versions, snapshot) == 0) {
+    DBUG_PRINT(LOG_TAG, ("load_table_snapshot: cache hit for table = %s",
+                         tablename.c_str()));
+    return snapshot;
+  }
+
+  // Apply the changes since the cached rows instead of reading all rows
+  std::vector<uint64_t> cached_versions;
+  if (versioned &&
+      cache.lookup_outdated(tablename, cached_versions, snapshot) == 0 &&
+      cached_versions.size() == versions.size()) {
+    if (update_table_snapshot(adapters, cached_versions, tokens, encryption,
+                              snapshot) == 0) {
+      DBUG_PRINT(LOG_TAG, ("load_table_snapshot: updated cached table = %s",
+                           tablename.c_str()));
+      cache.store(tablename, std::move(versions), snapshot);
+      return snapshot;
+    }
+    snapshot = TableSnapshot();
+  }
+
+  // Tablescan: read and decrypt all shards concurrently
+  std::vector<TABLE_MAP> shard_rows(adapters.size());
+  std::vector<ShardExecutor::TASK> scan_tasks;
+  for (size_t i = 0; i < adapters.size(); i++) {
+    scan_tasks.emplace_back(
+        [adapter = adapters[i], &token = tokens[i], &rows = shard_rows[i],
+         encryption] {
+          std::map<const BYTES, BYTES> table_map;
+          int status = adapter->get_all_at(table_map, token);
+          if (status != 0) {
+            // adapters keep the progress of a failed scan in the token,
+            // calling again with the same rows only reads the missing ones
+            status = adapter->get_all_at(table_map, token);
+          }
+
+          for (auto &entry : table_map) {
+            decrypt_value(entry.second, encryption);
+            rows.emplace_hint(rows.end(), entry.first,
+                              std::move(entry.second));
+          }
+          return status;
+        });
+  }
+  std::vector<int> scan_results =
+      read_executor->run_all(std::move(scan_tasks));
+
+  // Shards hold disjoint keys, merging splices the nodes of all shards into
+  // the rows of the snapshot without copying them
+  TABLE_MAP &rows = snapshot.write();
+  for (size_t i = 0; i < shard_rows.size(); i++) {
+    if (scan_results[i] != 0) {
+      // don't cache incomplete tables
+      DBUG_PRINT(LOG_TAG, ("load_table_snapshot: scan of shard %zu failed",
+                           i));
+      versioned = false;
+    }
+    rows.merge(shard_rows[i]);
+  }
+
+  if (versioned) {
+    cache.store(tablename, std::move(versions), snapshot);
+  }
+  return snapshot;
+}
+
 /**
   @brief
   This create a lock on the table. If you are implementing a storage engine
@@ -1613,101 +1916,57 @@ int ha_blockchain::external_lock(THD *thd, int lock_type) {
     DBUG_PRINT(LOG_TAG, ("external_lock: full_table_name = %s",
                          full_table_name.str().c_str()));
 
-    // Convert vector of tuples to map
-    std::map<BYTES, BYTES> table_map_final;
-
-    // process table on meta_chain and data_chain differently
-    // for tables on meta_chain, table_name = (meta_table, data_chains,
-    // shared_tables)
-    if ((table->s->table_name.str == META_TABLE_NAME) ||
-        (table->s->table_name.str == META_TABLE_DATA_CHAINS_NAME) ||
-        (table->s->table_name.str == SHARED_TABLES_NAME) ||
-        (table->s->table_name.str == KEY_STORE_NAME)) {
-      // define bc_adapter_map_key for table_name
-      std::string bc_adapter_map_key = full_table_name.str();
-      auto it = bc_adapter_map.find(bc_adapter_map_key);
-
-      if (it != bc_adapter_map.end()) {
-        // Tablescan
-        std::map<const BYTES, BYTES> table_map;
-        it->second->get_all(table_map);
-
-        for (auto entry : table_map) {
-          // if database has encryption key and iv so all corresponding tables
-          // will have encryption key and iv
-          if (encryption_config_map.find(table->s->db.str) !=
-              encryption_config_map.end()) {
-            size_t encrypted_value_size = entry.second.size;
-            unsigned char *decrypted_value =
-                new unsigned char[encrypted_value_size];
-
-            size_t decrypted_value_size =
-                decrypt(entry.second.value, encrypted_value_size,
-                        encryption_config_map[table->s->db.str].encryption_key,
-                        encryption_config_map[table->s->db.str].encryption_iv,
-                        decrypted_value);
-            BYTES decrypted_bytes =
-                BYTES(decrypted_value, decrypted_value_size);
-            table_map_final.emplace(entry.first, decrypted_bytes);
-
-            // delete all allocated memory
-            delete[] decrypted_value;
-          } else {
-            BYTES value_bytes = BYTES(entry.second.value, entry.second.size);
-            table_map_final.emplace(entry.first, value_bytes);
-          }
+    std::string tablename = full_table_name.str();
+
+    // Tables are read only once per transaction
+    if (txn->table_cache.find(tablename) == txn->table_cache.end()) {
+      // Adapters of all shards of the table and encryption config of its rows
+      std::vector<BcAdapter *> adapters;
+      ENCRYPTION_CONFIG *table_encryption = nullptr;
+
+      // process table on meta_chain and data_chain differently
+      // for tables on meta_chain, table_name = (meta_table, data_chains,
+      // shared_tables)
+      if ((table->s->table_name.str == META_TABLE_NAME) ||
+          (table->s->table_name.str == META_TABLE_DATA_CHAINS_NAME) ||
+          (table->s->table_name.str == SHARED_TABLES_NAME) ||
+          (table->s->table_name.str == KEY_STORE_NAME)) {
+        // tables on meta_chain have a single adapter keyed by the table name
+        auto it = bc_adapter_map.find(tablename);
+        if (it != bc_adapter_map.end()) {
+          adapters.push_back(it->second.get());
+        }
+        // if database has encryption key and iv so all corresponding tables
+        // will have encryption key and iv
+        if (encryption_config_map.find(table->s->db.str) !=
+            encryption_config_map.end()) {
+          table_encryption = &encryption_config_map[table->s->db.str];
         }
       }
-    }
-    // for tables on data_chain
-    else {
-      if (txn->table_cache.find(full_table_name.str()) !=
-          txn->table_cache.end()) {
-        return 0;
-      }
-      // get number of data_chains (shards)
-      int num_shards = num_shards_db;
-      // // loop through data_chains
-      for (int shard_number = 0; shard_number < num_shards; shard_number++) {
-        // define bc_adapter_map_key for table_name and data_chain_id
-        std::string bc_adapter_map_key =
-            full_table_name.str() + std::to_string(shard_number);
-        auto it = bc_adapter_map.find(bc_adapter_map_key);
-        if (it != bc_adapter_map.end()) {
-          // Tablescan
-          std::map<const BYTES, BYTES> table_map;
-          it->second->get_all(table_map);
-
-          for (auto entry : table_map) {
-            // if database has encryption key and iv so all corresponding tables
-            // will have encryption key and iv
-            if (encryption_config_map.find(table->s->db.str) !=
-                encryption_config_map.end()) {
-              size_t encrypted_value_size = entry.second.size;
-              unsigned char *decrypted_value =
-                  new unsigned char[encrypted_value_size];
-              // if table is not meta_table data should be decoded using
-              // corresponding table's encryptionkey and iv
-              size_t decrypted_value_size = decrypt(
-                  entry.second.value, encrypted_value_size,
-                  encryption_config_map[full_table_name.str()].encryption_key,
-                  encryption_config_map[full_table_name.str()].encryption_iv,
-                  decrypted_value);
-              BYTES decrypted_bytes =
-                  BYTES(decrypted_value, decrypted_value_size);
-              table_map_final.emplace(entry.first, decrypted_bytes);
-              delete[] decrypted_value;
-            } else {
-              BYTES value_bytes = BYTES(entry.second.value, entry.second.size);
-              table_map_final.emplace(entry.first, value_bytes);
-            }
+      // for tables on data_chain
+      else {
+        // loop through data_chains (shards)
+        for (int shard_number = 0; shard_number < num_shards_db;
+             shard_number++) {
+          // define bc_adapter_map_key for table_name and data_chain_id
+          auto it =
+              bc_adapter_map.find(tablename + std::to_string(shard_number));
+          if (it != bc_adapter_map.end()) {
+            adapters.push_back(it->second.get());
           }
         }
+        // if table is not meta_table data should be decoded using
+        // corresponding table's encryptionkey and iv
+        if (encryption_config_map.find(table->s->db.str) !=
+            encryption_config_map.end()) {
+          table_encryption = &encryption_config_map[tablename];
+        }
       }
-    }
 
-    // Add map to table cache of transaction
-    txn->addTable(full_table_name.str(), table_map_final);
+      // Add table to table cache of transaction
+      txn->addTable(tablename,
+                    load_table_snapshot(tablename, adapters, table_encryption));
+    }
 
     // register statement transaction
     trans_register_ha(thd, false, blockchain_hton, nullptr);
@@ -1854,25 +2113,18 @@ int ha_blockchain::start_stmt(THD *thd, thr_lock_type) {
  * Helper methods *
  ******************/
 
-int ha_blockchain::find_current_row(uchar *buf) {
-  // DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: find_current_row"));
-  return find_row(current_position, buf);
-}
-
-int ha_blockchain::find_row(my_off_t index, uchar *buf) {
-  // DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: find_row"));
+int ha_blockchain::read_row(const TABLE_MAP::value_type &row, uchar *buf) {
+  // DBUG_PRINT(LOG_TAG, ("ha_blockchain_method_call: read_row"));
   //  set required zero
   uint initial_null_bytes = table->s->null_bytes;
   memset(buf, 0, table->s->reclength);
+  memcpy(buf + initial_null_bytes, row.second.value, row.second.size);
 
-  try {
-    // Get value from result vector at index
-    memcpy(buf + initial_null_bytes, std::get<1>(all_items.at(index)).value,
-           std::get<1>(all_items.at(index)).size);
-
-  } catch (const std::out_of_range &) {
-    return HA_ERR_END_OF_FILE;
-  }
+  // Remember key for position(), keys are sha256 hashes (HASH_SIZE)
+  size_t key_size = std::min(row.first.size, MAX_BC_KEY_SIZE);
+  current_key[0] = static_cast<uchar>(key_size);
+  memcpy(current_key + 1, row.first.value, key_size);
+  memset(current_key + 1 + key_size, 0, MAX_BC_KEY_SIZE - key_size);
 
   return 0;
 }
@@ -1892,8 +2144,23 @@ static MYSQL_SYSVAR_STR(
     "Path to BlockchainManager and BlockchainAdapter configuration folder",
     nullptr, nullptr, nullptr);
 
+static MYSQL_SYSVAR_UINT(
+    bc_shard_threads, config_shard_threads,
+    PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+    "Maximum number of shards that are committed to the blockchain "
+    "concurrently",
+    nullptr, nullptr, 8, 1, 256, 0);
+
+static MYSQL_SYSVAR_UINT(
+    bc_read_threads, config_read_threads,
+    PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+    "Maximum number of shards that are read from the blockchain concurrently",
+    nullptr, nullptr, 8, 1, 256, 0);
+
 static SYS_VAR *blockchain_system_variables[] = {
     MYSQL_SYSVAR(bc_configuration_path),
+    MYSQL_SYSVAR(bc_shard_threads),
+    MYSQL_SYSVAR(bc_read_threads),
     nullptr};  // config path for configurations
 
 // Plugin descriptor
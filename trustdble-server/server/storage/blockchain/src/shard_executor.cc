@@ -0,0 +1,73 @@
+#include "blockchain/shard_executor.h"
+
+using namespace trustdble;
+
+ShardExecutor::ShardExecutor(size_t num_threads) {
+    if (num_threads == 0)
+        num_threads = 1;
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+        workers_.emplace_back(&ShardExecutor::work, this);
+    }
+}
+
+ShardExecutor::~ShardExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    queue_changed_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+auto ShardExecutor::run_all(std::vector<TASK> tasks) -> std::vector<int> {
+    std::vector<int> results(tasks.size(), 0);
+    if (tasks.size() == 1) {
+        // nothing to overlap with, avoid the hand-off to a worker
+        try {
+            results[0] = tasks[0]();
+        } catch (...) {
+            results[0] = 1;
+        }
+        return results;
+    }
+
+    std::vector<std::future<int>> futures;
+    futures.reserve(tasks.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &task : tasks) {
+            queue_.emplace_back(std::move(task));
+            futures.push_back(queue_.back().get_future());
+        }
+    }
+    queue_changed_.notify_all();
+
+    for (size_t i = 0; i < futures.size(); i++) {
+        try {
+            results[i] = futures[i].get();
+        } catch (...) {
+            // exceptions of a task must not escape into the server
+            results[i] = 1;
+        }
+    }
+    return results;
+}
+
+void ShardExecutor::work() {
+    while (true) {
+        std::packaged_task<int()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queue_changed_.wait(lock,
+                                [this] { return stopped_ || !queue_.empty(); });
+            if (queue_.empty())
+                return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,48 @@
+#include "blockchain/table_cache.h"
+
+using namespace trustdble;
+
+auto SharedTableCache::instance() -> SharedTableCache & {
+    static SharedTableCache cache;
+    return cache;
+}
+
+auto SharedTableCache::lookup(const std::string &tablename,
+                              const std::vector<uint64_t> &versions,
+                              TableSnapshot &snapshot) -> int {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(tablename);
+    if (it == entries_.end())
+        return 1;
+    if (it->second.versions != versions) {
+        // table changed on the blockchain, the outdated rows are kept for
+        // lookup_outdated()
+        return 1;
+    }
+    snapshot = it->second.snapshot;
+    return 0;
+}
+
+auto SharedTableCache::lookup_outdated(const std::string &tablename,
+                                       std::vector<uint64_t> &versions,
+                                       TableSnapshot &snapshot) -> int {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(tablename);
+    if (it == entries_.end())
+        return 1;
+    versions = it->second.versions;
+    snapshot = it->second.snapshot;
+    return 0;
+}
+
+void SharedTableCache::store(const std::string &tablename,
+                             std::vector<uint64_t> versions,
+                             const TableSnapshot &snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[tablename] = ENTRY{std::move(versions), snapshot};
+}
+
+void SharedTableCache::invalidate(const std::string &tablename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(tablename);
+}
@@ -0,0 +1,42 @@
+#include "blockchain/shard_executor.h"
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+using namespace trustdble;
+
+TEST(ShardExecutor, ReportsStatusPerTask) {
+    ShardExecutor executor(4);
+    std::vector<ShardExecutor::TASK> tasks;
+    tasks.emplace_back([] { return 0; });
+    tasks.emplace_back([] { return 1; });
+    tasks.emplace_back([]() -> int { throw std::runtime_error("failed"); });
+    tasks.emplace_back([] { return 0; });
+
+    std::vector<int> results = executor.run_all(std::move(tasks));
+    EXPECT_EQ(results, std::vector<int>({0, 1, 1, 0}));
+}
+
+TEST(ShardExecutor, RunsTasksConcurrently) {
+    ShardExecutor executor(2);
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    auto task = [&] {
+        int now = ++running;
+        int max = max_running;
+        while (now > max && !max_running.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        --running;
+        return 0;
+    };
+
+    // four tasks on two threads: two run at a time, never more
+    std::vector<ShardExecutor::TASK> tasks(4, task);
+    executor.run_all(std::move(tasks));
+
+    EXPECT_EQ(max_running, 2);
+}
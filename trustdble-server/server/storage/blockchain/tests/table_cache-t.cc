@@ -0,0 +1,44 @@
+#include "blockchain/table_cache.h"
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+using namespace trustdble;
+
+TEST(TableCache, SnapshotCopyOnWrite) {
+    TableSnapshot snapshot;
+    snapshot.write().emplace(BYTES("key"), BYTES("value"));
+
+    // a copy shares the rows until it is modified
+    TableSnapshot copy = snapshot;
+    EXPECT_EQ(&snapshot.read(), &copy.read());
+
+    copy.write().erase(BYTES("key"));
+    EXPECT_NE(&snapshot.read(), &copy.read());
+    EXPECT_EQ(snapshot.read().size(), 1);
+    EXPECT_TRUE(copy.read().empty());
+}
+
+TEST(TableCache, LookupMatchesVersions) {
+    SharedTableCache &cache = SharedTableCache::instance();
+    TableSnapshot rows;
+    rows.write().emplace(BYTES("key"), BYTES("value"));
+    cache.store("./db/cached", {1, 7}, rows);
+
+    TableSnapshot hit;
+    EXPECT_EQ(cache.lookup("./db/cached", {1, 7}, hit), 0);
+    EXPECT_EQ(&hit.read(), &rows.read());
+
+    // a changed shard version drops the entry
+    TableSnapshot miss;
+    EXPECT_EQ(cache.lookup("./db/cached", {1, 8}, miss), 1);
+    EXPECT_EQ(cache.lookup("./db/cached", {1, 7}, miss), 1);
+}
+
+TEST(TableCache, Invalidate) {
+    SharedTableCache &cache = SharedTableCache::instance();
+    cache.store("./db/invalidated", {3}, TableSnapshot());
+    cache.invalidate("./db/invalidated");
+
+    TableSnapshot snapshot;
+    EXPECT_EQ(cache.lookup("./db/invalidated", {3}, snapshot), 1);
+}
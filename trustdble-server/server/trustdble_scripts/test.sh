@@ -71,7 +71,7 @@ connection-url=http://127.0.0.1:8001
 account=0x542BB0f7035f4bf7dB677a54B73e5d0514B9bfBC
 max-waiting-time=300
 script-path=${DEPENDENCY_DIR}/trustdble-adapters-src/ethereum/scripts
-contract-path=${DEPENDENCY_DIR}/trustdble-adapters-src/ethereum/contract/truffle/build/contracts/SimpleStorage.json
+contract-path=${DEPENDENCY_DIR}/trustdble-adapters-src/ethereum/contract/truffle/build/contracts/TableStorageV2.json
 
 [Adapter-Stub]
 data-path=$(pwd)/suite/trustdble/stub_data/